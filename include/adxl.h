@@ -4,8 +4,18 @@ extern "C" {
 #endif
 #define ADXL345_ADDRESS 0x53
 #define ADXL345_POWER_CTL 0x2D
+#define ADXL345_INT_ENABLE 0x2E
+#define ADXL345_INT_MAP 0x2F
 #define ADXL345_DATA_FORMAT 0x31
 #define ADXL345_DATAX0 0x32
+#define ADXL345_FIFO_CTL 0x38
+#define ADXL345_FIFO_STATUS 0x39
+#define ADXL345_FIFO_STREAM 0x80
+#define ADXL345_INT_WATERMARK 0x02
+#define ADXL345_INT_INVERT 0x20
+#define ADXL345_FIFO_ENTRIES 0x3F
+// Convert a filter coefficient between 0 and 1 to Q15
+#define ADXL_ALPHA_Q15(alpha) ((alpha) >= 1.0 ? INT16_MAX : (int16_t)((alpha) * 32768 + 0.5))
 #define ADXL345_GRAVITY_EARTH        9.80665f
 void tick_adxl();
 void init_adxl();
@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include "midi_descriptors.h"
+#include "wt.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -48,6 +49,8 @@ enum SerialCommands {
     COMMAND_READ_MAX170X_VALID,
     COMMAND_READ_MIDI,
     COMMAND_SET_ADXL_FILTER,
+    COMMAND_READ_LOG,
+    COMMAND_READ_USB_HOST_HID_STATUS,
     MAX=100
 };
 
@@ -59,6 +62,7 @@ extern uint8_t lastSuccessfulGH5Packet[2];
 extern uint8_t lastSuccessfulClonePacket[4];
 extern uint8_t wiiBytes;
 extern uint32_t lastWt[5];
+extern Wt_Baseline_t wtBaselines[5];
 extern uint8_t rawWt;
 extern uint8_t rawWtPeripheral;
 extern bool lastGH5WasSuccessful;
@@ -78,7 +82,7 @@ extern uint16_t lastMpr121;
 extern bool max170x_init;
 extern uint8_t lastBattery;
 extern Midi_Data_t midiData;
-extern double currentLowPassAlpha;
+extern int16_t currentLowPassAlpha;
 #ifdef __cplusplus
 }
 #endif
\ No newline at end of file
@@ -467,6 +467,23 @@ inline double read_double(uint16_t idx) {
 
 extern bool disable_multiplexer;
 
+// The first USB_HOST_PASSTHROUGH host slots each get their own xinput interface on windows, instead of
+// being merged into the main one. XInput only has four players, so at most three can be passed through.
+// Interfaces are fixed when the pc enumerates us, so each one reports the subtype set for its slot in
+// USB_HOST_PASSTHROUGH_SUBTYPES (gamepad by default), no matter what is plugged in later.
+// Xbox 360 controllers are forwarded untouched, so their slot should be set to their subtype.
+// Everything else is always sent as a gamepad report, whatever its slot reports.
+#if !defined(INPUT_USB_HOST) || !defined(USB_HOST_PASSTHROUGH)
+#undef USB_HOST_PASSTHROUGH
+#define USB_HOST_PASSTHROUGH 0
+#elif USB_HOST_PASSTHROUGH > 3
+#error USB_HOST_PASSTHROUGH can be at most 3
+#endif
+#ifndef USB_HOST_PASSTHROUGH_SUBTYPES
+#define USB_HOST_PASSTHROUGH_SUBTYPES {XINPUT_GAMEPAD, XINPUT_GAMEPAD, XINPUT_GAMEPAD}
+#endif
+#define USB_HOST_PASSTHROUGH_SLOTS (consoleType == WINDOWS ? USB_HOST_PASSTHROUGH : 0)
+
 #if SUPPORTS_PICO
 #ifdef TWI_1_OUTPUT
 #define RXWIRE Wire1
@@ -46,6 +46,13 @@ typedef struct {
     USB_INTERFACE_DESCRIPTOR InterfaceSecurity;
     uint8_t SecurityDescriptor[0x06];
 } __attribute__((packed)) XBOX_360_CONFIGURATION_DESCRIPTOR;
+// Same layout as the gamepad interface in XBOX_360_CONFIGURATION_DESCRIPTOR, repeated for each passthrough interface
+typedef struct {
+    USB_INTERFACE_DESCRIPTOR InterfaceGamepad;
+    XBOX_ID_DESCRIPTOR GamepadDescriptor;
+    USB_ENDPOINT_DESCRIPTOR ReportINEndpoint;
+    USB_ENDPOINT_DESCRIPTOR ReportOUTEndpoint;
+} __attribute__((packed)) XBOX_360_PASSTHROUGH_DESCRIPTOR;
 
 typedef struct {
     USB_CONFIGURATION_DESCRIPTOR Config;
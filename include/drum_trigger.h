@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+
+#include "config.h"
+#ifdef INPUT_DRUM_TRIGGER
+// Piezo trigger detection, fed from the free running ADC instead of being sampled once per tick.
+// DRUM_TRIGGER_MASK selects which analog inputs (by index) are piezo pads.
+// A hit starts once a pad crosses the threshold, the highest reading during the scan window
+// becomes its velocity, and the pad then ignores itself for the retrigger mask time.
+// Each hit is queued as an event with the time it was detected. The tick drains the queue, and
+// the report and MIDI paths see each hit for DRUM_TRIGGER_HOLD_US from that time.
+#ifndef DRUM_TRIGGER_THRESHOLD
+#define DRUM_TRIGGER_THRESHOLD 2048
+#endif
+#ifndef DRUM_TRIGGER_SCAN_US
+#define DRUM_TRIGGER_SCAN_US 2000
+#endif
+#ifndef DRUM_TRIGGER_RETRIGGER_US
+#define DRUM_TRIGGER_RETRIGGER_US 30000
+#endif
+// A hit within the scan window of a louder hit on another pad is dropped as crosstalk
+// if it is quieter than this fraction (Q8) of the louder one
+#ifndef DRUM_TRIGGER_CROSSTALK
+#define DRUM_TRIGGER_CROSSTALK 128
+#endif
+// A hit keeps being reported for this long after it was detected, so every poll in that window sees it
+// regardless of when the tick happened to run. This should stay below the retrigger mask time.
+#ifndef DRUM_TRIGGER_HOLD_US
+#define DRUM_TRIGGER_HOLD_US 10000
+#endif
+// Hits waiting for the tick, this has to be a power of two
+#define DRUM_TRIGGER_QUEUE_SIZE 16
+#if SUPPORTS_PICO
+// RP2040 samples every ADC input round robin, at this rate per input
+#define DRUM_TRIGGER_CHANNELS 4
+#define DRUM_TRIGGER_RATE 25000UL
+#else
+// AVR converts each configured analog pin in turn, at ADC clock (F_CPU / 16) / 13 cycles
+#define DRUM_TRIGGER_CHANNELS ADC_COUNT
+#define DRUM_TRIGGER_RATE (F_CPU / 16 / 13 / ADC_COUNT)
+#endif
+#define DRUM_TRIGGER_SCAN_SAMPLES ((uint16_t)(DRUM_TRIGGER_SCAN_US * DRUM_TRIGGER_RATE / 1000000UL))
+#define DRUM_TRIGGER_RETRIGGER_SAMPLES ((uint16_t)(DRUM_TRIGGER_RETRIGGER_US * DRUM_TRIGGER_RATE / 1000000UL))
+
+typedef struct {
+    uint32_t time;
+    uint16_t velocity;
+    uint8_t channel;
+} Drum_Trigger_Event_t;
+// Called from the ADC interrupt for every sample on a pad. Returns true once a hit has been scanned,
+// and the caller then queues it with drumTriggerHit, so the clock is only read when there is a hit.
+bool drumTriggerSample(uint8_t channel, uint16_t value);
+// Queues the hit that was just scanned on a pad, time is in micros
+void drumTriggerHit(uint8_t channel, uint32_t time);
+// Takes the oldest queued hit, returning false if there are none
+bool drumTriggerPop(Drum_Trigger_Event_t *event);
+// Drains the queue, holding each hit for DRUM_TRIGGER_HOLD_US from when it was detected
+void drumTriggerTick(uint32_t now);
+// Returns the velocity of a pad's last hit while it is held, or 0
+uint16_t drumTriggerRead(uint8_t channel);
+#endif
@@ -13,7 +13,10 @@ enum endpoints_t {
     XINPUT_AUDIO_OUT = ENDPOINT_OUT | 6,
     XINPUT_UNK_IN = ENDPOINT_IN | 7,
     XINPUT_UNK_OUT = ENDPOINT_OUT | 8,
-    XINPUT_PLUGIN_MODULE_IN = ENDPOINT_IN | 9
+    XINPUT_PLUGIN_MODULE_IN = ENDPOINT_IN | 9,
+    // Passthrough interface n uses endpoint 10 + n in both directions
+    XINPUT_PASSTHROUGH_IN = ENDPOINT_IN | 10,
+    XINPUT_PASSTHROUGH_OUT = ENDPOINT_OUT | 10
 };
 
 #define SERIAL_TX_SIZE 32
@@ -127,6 +130,7 @@ enum interfaces_t {
     INTERFACE_ID_Config = 2, /**< Config interface descriptor ID */
     INTERFACE_ID_XBOX_Security = 3,
     INTERFACE_ID_Xone_Device = 4,
+    INTERFACE_ID_Passthrough = 4, /**< First USB host passthrough interface, after the xbox 360 ones */
     INTERFACE_ID_ControlStream =
         0, /**< MIDI Control Stream interface descriptor ID */
     INTERFACE_ID_AudioStream =
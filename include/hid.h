@@ -93,6 +93,11 @@ extern const uint8_t pc_descriptor[134];
 #endif
 void handle_auth_led(void);
 void handle_player_leds(uint8_t player);
+void handle_player_leds_xinput_w(uint8_t dev_addr, uint8_t instance);
+#if USB_HOST_PASSTHROUGH
+// Forwards a rumble or led report from the pc to the host device behind passthrough interface id
+void handle_usb_host_passthrough_output(uint8_t id, const uint8_t *data, uint8_t len);
+#endif
 void handle_rumble(uint8_t rumble_left, uint8_t rumble_right);
 void handle_keyboard_leds(uint8_t leds);
 void tick_leds(void);
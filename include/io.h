@@ -34,7 +34,6 @@ void init_att();
 void read_serial(uint8_t* id, uint8_t len);
 extern volatile bool spi_acknowledged;
 #ifdef INPUT_WT_NECK
-void initWt();
 uint8_t tickWt();
 #endif
 extern void recv_data(uint8_t addr, uint8_t data);
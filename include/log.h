@@ -0,0 +1,52 @@
+#pragma once
+#include <stdint.h>
+
+#include "config.h"
+// Deferred logging. Instead of formatting on the spot, a log call stores the address of its
+// format string, a timestamp and up to four arguments in a ring buffer. Records are pulled out
+// over COMMAND_READ_LOG and decoded by log_decode.py, which looks the format strings up in the
+// firmware ELF, or printed from the main loop when LOG_PRINT is defined.
+// Logging is off unless a build asks for it, e.g. with -DLOG_LEVEL=LOG_LEVEL_INFO in build_flags.
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_INFO 2
+#define LOG_LEVEL_DEBUG 3
+#ifndef LOG_LEVEL
+#define LOG_LEVEL LOG_LEVEL_NONE
+#endif
+#ifndef LOG_BUFFER_SIZE
+#define LOG_BUFFER_SIZE 64
+#endif
+#define LOG_MAX_ARGS 4
+
+typedef struct {
+    uint32_t format;
+    uint32_t timestamp;
+    uint32_t args[LOG_MAX_ARGS];
+} __attribute__((packed)) Log_Record_t;
+
+#if LOG_LEVEL > LOG_LEVEL_NONE
+extern Log_Record_t logBuffer[LOG_BUFFER_SIZE];
+extern volatile uint8_t logHead;
+extern volatile uint8_t logTail;
+extern volatile uint8_t logDropped;
+void logWrite(const char* format, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, uint32_t d = 0);
+// Copies out as many pending records as fit in length bytes, and returns the number of bytes written
+uint8_t logRead(uint8_t* dest, uint8_t length);
+// Formats and prints a single pending record
+void logPrintPending();
+#define LOG_AT(level, format, ...)                         \
+    do {                                                   \
+        if (LOG_LEVEL >= level) {                          \
+            static const char fmt[] = format;              \
+            logWrite(fmt, ##__VA_ARGS__);                  \
+        }                                                  \
+    } while (0)
+#else
+#define LOG_AT(level, format, ...) \
+    do {                           \
+    } while (0)
+#endif
+#define LOG_ERROR(format, ...) LOG_AT(LOG_LEVEL_ERROR, format, ##__VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT(LOG_LEVEL_INFO, format, ##__VA_ARGS__)
+#define LOG_DEBUG(format, ...) LOG_AT(LOG_LEVEL_DEBUG, format, ##__VA_ARGS__)
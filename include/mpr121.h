@@ -1,6 +1,44 @@
 #define MPR121_I2CADDR_DEFAULT 0x5A        ///< default I2C address
 #define MPR121_TOUCH_THRESHOLD_DEFAULT 5  ///< default touch threshold value
 #define MPR121_RELEASE_THRESHOLD_DEFAULT 1 ///< default relese threshold value
+#include "config.h"
+// Chip side filtering, each of these can be overridden by the config
+#ifndef MPR121_TOUCH_THRESHOLD
+#define MPR121_TOUCH_THRESHOLD MPR121_TOUCH_THRESHOLD_DEFAULT
+#endif
+#ifndef MPR121_RELEASE_THRESHOLD
+#define MPR121_RELEASE_THRESHOLD MPR121_RELEASE_THRESHOLD_DEFAULT
+#endif
+// Number of consecutive samples (0-7) needed before a touch / release is reported
+#ifndef MPR121_DEBOUNCE_TOUCH
+#define MPR121_DEBOUNCE_TOUCH 0
+#endif
+#ifndef MPR121_DEBOUNCE_RELEASE
+#define MPR121_DEBOUNCE_RELEASE 0
+#endif
+// First filter iterations (0-3 for 6, 10, 18 or 34 samples)
+#ifndef MPR121_FFI
+#define MPR121_FFI 0
+#endif
+// Second filter iterations (0-3 for 4, 6, 10 or 18 samples)
+#ifndef MPR121_SFI
+#define MPR121_SFI 0
+#endif
+// Electrode sample interval (0-7 for 1ms * 2^n)
+#ifndef MPR121_ESI
+#define MPR121_ESI 0
+#endif
+// Rising / falling baseline filter: max half delta, noise half delta, noise count limit and filter delay
+#ifndef MPR121_BASELINE_RISING
+#define MPR121_BASELINE_RISING 0x01, 0x01, 0x0E, 0x00
+#endif
+#ifndef MPR121_BASELINE_FALLING
+#define MPR121_BASELINE_FALLING 0x01, 0x05, 0x01, 0x00
+#endif
+// Baseline tracking on start (0-3 for off, keep the stored baseline, load the top 5 bits or all 10 bits)
+#ifndef MPR121_BASELINE_TRACKING
+#define MPR121_BASELINE_TRACKING 2
+#endif
 enum {
   MPR121_TOUCHSTATUS_L = 0x00,
   MPR121_TOUCHSTATUS_H = 0x01,
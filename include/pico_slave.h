@@ -1,3 +1,4 @@
+#pragma once
 #include "config.h"
 #define SLAVE_ADDR 0x75
 #define SLAVE_COMMAND_SET_PINMODE         0x01
@@ -10,6 +11,23 @@
 #define SLAVE_COMMAND_GET_WT              0x0B
 #define SLAVE_COMMAND_GET_WT_RAW          0x0C
 #define SLAVE_COMMAND_INITIALISE          0x0D
+#define SLAVE_COMMAND_GET_SNAPSHOT        0x0E
+#define SLAVE_COMMAND_INIT_INTERRUPT      0x0F
+#define SLAVE_COMMAND_WRITE_SPI_FRAME     0x10
+#define SLAVE_COMMAND_GET_WT_TRACKING     0x11
+
+// Largest LED frame chunk sent in a single transaction, leaving room for the command byte
+#define SLAVE_SPI_FRAME_MAX (TWI_BUFFER_LENGTH - 1)
+
+// Optional data ready line, both set by the config:
+// SLAVE_INTERRUPT is the pin on the main controller that the line is wired to, and
+// SLAVE_INTERRUPT_PERIPHERAL is the GPIO on the peripheral that drives it.
+// The main controller pulls the line up, and the peripheral pulls it low when its snapshot changes.
+#if defined(SLAVE_INTERRUPT) && !defined(SLAVE_INTERRUPT_PERIPHERAL)
+#error SLAVE_INTERRUPT needs SLAVE_INTERRUPT_PERIPHERAL to be set as well
+#endif
+// With an interrupt line, the peripheral is still read at this interval (ms) even if it hasn't signalled a change
+#define SLAVE_HEARTBEAT_INTERVAL 100
 
 #define PIN_MODE_INPUT_PULLUP   0
 #define PIN_MODE_INPUT          1
@@ -19,10 +37,37 @@
 #define PIN_MODE_OUTPUT         5
 #define PIN_MODE_SPI            6
 
+#define SLAVE_ANALOG_COUNT      3
+#define SLAVE_WT_COUNT          5
+
+// Everything the main controller needs from the peripheral, read in a single transaction.
+// The sequence number is bumped by the peripheral whenever the contents change, so the main
+// controller can skip a snapshot it has already seen, and the checksum is an xor of every byte before it.
+typedef struct {
+    uint8_t header;
+    uint8_t sequence;
+    uint32_t digital;
+    uint8_t wt;
+    uint16_t wtRaw[SLAVE_WT_COUNT];
+    uint16_t analog[SLAVE_ANALOG_COUNT];
+    uint8_t checksum;
+} __attribute__((packed)) Slave_Snapshot_t;
+
+static inline uint8_t slaveSnapshotChecksum(const Slave_Snapshot_t* snapshot) {
+    const uint8_t* data = (const uint8_t*)snapshot;
+    uint8_t checksum = 0;
+    for (uint8_t i = 0; i < sizeof(Slave_Snapshot_t) - 1; i++) {
+        checksum ^= data[i];
+    }
+    return checksum;
+}
+
 #ifdef SLAVE_TWI_PORT
 void slavePinMode(uint8_t pin, uint8_t pinMode);
 
 uint32_t slaveReadDigital(void);
+bool slaveReadSnapshot(void);
+extern Slave_Snapshot_t slaveSnapshot;
 
 
 uint8_t slaveReadDigital(uint8_t port, uint8_t mask);
@@ -30,10 +75,13 @@ uint8_t slaveReadDigital(uint8_t port, uint8_t mask);
 void slaveWriteDigital(uint8_t pin, bool output);
 uint8_t slaveReadWt(void);
 uint8_t slaveReadWtRaw(uint8_t* dest);
+uint16_t slaveReadAnalog(uint8_t channel);
 bool slaveInit(void);
 void slaveInitWt(void);
+void slaveInitInterrupt(void);
 void slaveSetWtCounter(uint16_t counter);
 void slaveInitLED(uint8_t instance);
 void slaveWriteLED(uint8_t data);
+void slaveFlushLED(void);
 void slaveWriteAnalog(uint8_t pin, uint8_t val);
 #endif
\ No newline at end of file
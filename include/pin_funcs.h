@@ -11,4 +11,7 @@ uint16_t adc(uint8_t pin);
 uint8_t digital_read(uint8_t port, uint8_t mask);
 uint16_t adc_read(uint8_t pin, uint8_t mask);
 uint16_t multiplexer_read(uint8_t pin, uint32_t mask, uint32_t bits);
-void digital_write(uint8_t port, uint8_t mask, uint8_t activeMask);
\ No newline at end of file
+void digital_write(uint8_t port, uint8_t mask, uint8_t activeMask);
+// Single pin access for interrupt / data ready lines from external chips
+void pin_init_pullup(uint8_t pin);
+bool pin_read(uint8_t pin);
\ No newline at end of file
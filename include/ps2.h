@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include "config.h"
+#include "reports/controller_reports.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,6 +42,38 @@ extern "C" {
  * edge (us).
  */
 #define ATTN_DELAY 50
+
+/** \brief Number of ports polled each sweep
+ *
+ * With a multitap, all four ports are polled back to back every tick.
+ */
+#ifdef INPUT_PS2_MULTITAP
+#define PS2_PORT_COUNT 4
+#else
+#define PS2_PORT_COUNT 1
+#endif
+
+#ifdef INPUT_PS2_MULTITAP
+extern uint8_t lastSuccessfulPS2MultitapPackets[PS2_PORT_COUNT][BUFFER_SIZE];
+extern uint8_t lastPS2MultitapSuccessful;
+#endif
+
+/** \brief Use the PIO based PSX engine
+ *
+ * On the pico, if the PS2 ACK pin is known, the byte exchange and ACK wait are
+ * done by a PIO state machine and frames are moved with DMA, instead of
+ * blocking on the SPI hardware.
+ *
+ * The state machine takes over the pins the config already assigns to
+ * PS2_SPI_PORT (MOSI as CMD, MISO as DAT and SCK as CLK), so no extra config
+ * is needed. PS2_CMD, PS2_DAT and PS2_CLK can be defined to use other pins,
+ * and have to be if both SPI blocks have pins assigned.
+ */
+#if SUPPORTS_PICO && defined(PS2_ACK) && (defined(PS2_SPI_PORT) || (defined(PS2_CMD) && defined(PS2_DAT) && defined(PS2_CLK)))
+#define PS2_PIO 1
+#else
+#define PS2_PIO 0
+#endif
 enum PsxButton {
     // PSB_NONE,
     PSB_SELECT,
@@ -66,6 +99,43 @@ enum MultitapPort { A = 0x01,
                     D = 0x04 };
 extern uint8_t ps2ControllerType;
 uint8_t* tickPS2(void);
+uint8_t* ps2PortData(uint8_t port);
+uint8_t ps2PortControllerType(uint8_t port);
+/** \brief Decode a poll reply into USB host data
+ *
+ * Multitap ports B - D have no mappings of their own, so they are decoded the
+ * same way a USB host device is and merged into usb_host_data. Sticks and
+ * pressures are only decoded if the reply is long enough to carry them.
+ */
+void ps2DecodeUsbHostData(const uint8_t* packet, uint8_t controllerType, USB_Host_Data_t* out);
+typedef struct {
+    uint8_t port;
+    const uint8_t* command;
+    uint8_t len;
+} PS2Transfer_t;
+static inline bool ps2IsValidReply(const uint8_t* status) {
+    return status[1] != 0xFF && (status[2] == 0x5A || status[2] == 0x00);
+}
+// How many bytes follow the 3 byte header. The PIO engine calls this from its DMA interrupt, which runs
+// from RAM on the pico, so it is always inlined instead of being left in flash.
+static inline __attribute__((always_inline)) uint8_t ps2ReplyBodyLength(const uint8_t* header, uint8_t len) {
+    if (!ps2IsValidReply(header)) {
+        return 0;
+    }
+    uint8_t replyLen = (header[1] & 0x0F) * 2;
+    // Keep clocking until the whole command has been sent, even if the reply is shorter
+    if (replyLen < len - 2) {
+        replyLen = len - 2;
+    }
+    if (replyLen + 3 > BUFFER_SIZE) {
+        return 0;
+    }
+    return replyLen;
+}
+void ps2TransportInit(void);
+bool ps2TransportBusy(void);
+void ps2TransportStart(const PS2Transfer_t* transfers, uint8_t count);
+uint8_t* ps2TransportReply(uint8_t index);
 #ifdef TICK_PS2
 bool ps2_emu_tick(PS2_REPORT* report);
 void ps2_emu_init(void);
@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+
+#include "config.h"
+#ifdef RAPID_TRIGGER_COUNT
+// Rapid trigger for analog (hall effect) frets, strum and dance pad panels.
+// Instead of comparing against a fixed threshold, each input tracks the extreme point of its travel:
+// once pressed, it releases as soon as it moves back up by the release delta from the deepest point,
+// and once released, it presses again as soon as it moves down by the press delta from the highest point.
+// Values are travel, so a bigger value means the key is pressed further down. The actuation point only
+// guards the resting position: an input above it (less travel) is always released, and the first
+// press coming up from rest happens as soon as the actuation point is crossed.
+// This is library code for now: the analog to digital comparisons live in the TICK blocks emitted by
+// the config generator, and nothing in this tree calls rapidTrigger() until the generator emits it
+// in place of the fixed threshold for inputs that have rapid trigger turned on.
+#ifndef RAPID_TRIGGER_PRESS_DELTA
+#define RAPID_TRIGGER_PRESS_DELTA 2048
+#endif
+#ifndef RAPID_TRIGGER_RELEASE_DELTA
+#define RAPID_TRIGGER_RELEASE_DELTA 2048
+#endif
+#ifndef RAPID_TRIGGER_ACTUATION
+#define RAPID_TRIGGER_ACTUATION 8192
+#endif
+typedef struct {
+    uint16_t extreme;
+    bool pressed;
+} Rapid_Trigger_t;
+extern Rapid_Trigger_t rapidTriggers[RAPID_TRIGGER_COUNT];
+// Feeds a new reading for an input, and returns if it is currently pressed
+bool rapidTrigger(uint8_t index, uint16_t travel, uint16_t actuation, uint16_t pressDelta, uint16_t releaseDelta);
+static inline bool rapidTrigger(uint8_t index, uint16_t travel) {
+    return rapidTrigger(index, travel, RAPID_TRIGGER_ACTUATION, RAPID_TRIGGER_PRESS_DELTA, RAPID_TRIGGER_RELEASE_DELTA);
+}
+#endif
@@ -2,6 +2,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "midi_descriptors.h"
 #include "reports/og_xbox_reports.h"
 #include "reports/pc_reports.h"
 #include "reports/ps2_reports.h"
@@ -17,10 +18,11 @@
 #define STREAM_DECK_INPUT_REPORT_ID 1
 #define SIMULTANEOUS_KEYS 6
 #define NKRO_KEYS ((0x73 / 8) + 1)
-#define SIMULTANEOUS_MIDI 12
+// As many event packets as fit in the 0x20 byte MIDI IN endpoint
+#define SIMULTANEOUS_MIDI 8
 #define KEYCODE_F24 115
 typedef struct {
-    // TMIDI_EventPacket_t midi[SIMULTANEOUS_MIDI];
+    MIDI_EVENT_PACKET midi[SIMULTANEOUS_MIDI];
 } USB_MIDI_Data_t;
 
 typedef struct {
@@ -1,3 +1,4 @@
+#pragma once
 #include "pin_funcs.h"
 #include "reports/controller_reports.h"
 #include "config.h"
@@ -10,13 +11,21 @@ void tick_wiioutput();
 uint8_t tick_inputs(void *buf, USB_LastReport_Data_t *last_report, uint8_t output_console_type);
 void reset_usb(void);
 uint8_t transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength, uint8_t *buffer);
+// Queued control transfers go out in the background, one at a time. Pending host to device transfers
+// with the same request, value and index are replaced instead of queued again, so only the latest rumble or LED state is sent.
+#define USB_TRANSFER_QUEUE 4
+#define USB_TRANSFER_MAX_LEN 64
+// How long a blocking transfer waits for a queued transfer that is already in flight
+#define USB_TRANSFER_WAIT_MS 50
+typedef void (*usb_transfer_cb_t)(uint8_t dev_addr, bool success, const uint8_t *data, uint16_t len, uintptr_t user_data);
+bool queue_transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength, const uint8_t *buffer, usb_transfer_cb_t complete = NULL, uintptr_t user_data = 0);
 void send_report_to_controller(uint8_t dev_addr, uint8_t instance, const uint8_t *report, uint8_t len);
 void send_report_to_pc(const void *report, uint8_t len);
 bool ready_for_next_packet(void);
 bool usb_configured(void);
 void receive_report_from_controller(uint8_t const *report, uint16_t len);
 void xinput_controller_connected(uint16_t vid, uint16_t pid);
-void xinput_w_controller_connected();
+void xinput_w_controller_connected(uint8_t dev_addr, uint8_t instance);
 void xone_controller_connected(uint8_t dev_addr, uint8_t instance);
 bool xone_controller_send_init_packet(uint8_t dev_addr, uint8_t instance, uint8_t id);
 void ps4_controller_connected(uint8_t dev_addr, uint16_t vid, uint16_t pid);
@@ -93,9 +102,19 @@ USB_Device_Type_t get_device_address_for(uint8_t deviceType);
 #ifdef INPUT_USB_HOST
 void xone_disconnect(void);
 uint8_t read_usb_host_devices(uint8_t *buf);
+// One HID descriptor parse status per device, in the same order as read_usb_host_devices
+uint8_t read_usb_host_hid_status(uint8_t *buf);
 uint8_t get_usb_host_device_count();
+// Bitmask of the host device ids for a given console type
+uint64_t get_usb_host_devices_for(uint8_t console_type);
 USB_Device_Type_t get_usb_host_device_type(uint8_t id);
+// Changes whenever a different device is plugged into the slot for id
+uint8_t get_usb_host_device_generation(uint8_t id);
 uint8_t get_usb_host_device_data(uint8_t id, uint8_t *buf);
+// Returns if a report arrived for id since the last call, and clears the flag
+bool take_usb_host_device_changed(uint8_t id);
+// What id decoded to last time, kept so unchanged devices don't need decoding every tick
+USB_Host_Data_t *get_usb_host_device_decoded(uint8_t id);
 extern USB_Host_Data_t usb_host_data;
 extern USB_Host_Data_t last_usb_host_data;
 #endif
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdint.h>
+
+#include "config.h"
+#ifdef INPUT_DJ_TURNTABLE_SMOOTHING
+// Smoothing can be turned on for each platter separately
+#ifndef INPUT_DJ_TURNTABLE_SMOOTHING_LEFT
+#define INPUT_DJ_TURNTABLE_SMOOTHING_LEFT INPUT_DJ_TURNTABLE_SMOOTHING
+#endif
+#ifndef INPUT_DJ_TURNTABLE_SMOOTHING_RIGHT
+#define INPUT_DJ_TURNTABLE_SMOOTHING_RIGHT INPUT_DJ_TURNTABLE_SMOOTHING
+#endif
+// Filter coefficient (Q8) used while the platter is steady or changing slowly. 1/8 lags a slow
+// change by about 7 polls, on par with the 16 sample moving average this replaced, while still
+// being less noisy than it. 1/16 was quieter but lagged twice as long at low speeds.
+#define TURNTABLE_SMOOTHING_MIN_ALPHA 32
+// How much the coefficient grows (Q8) for each count per poll of change
+#define TURNTABLE_SMOOTHING_BETA 32
+// The rate of change is itself smoothed by a fixed 1/4 filter
+#define TURNTABLE_SMOOTHING_DERIVATIVE_SHIFT 2
+// One Euro style filter, in Q8 fixed point. A steady platter gets a heavy low pass,
+// while the coefficient opens up as the value starts changing so scratches aren't delayed.
+typedef struct {
+    int32_t value;
+    int32_t last;
+    int32_t derivative;
+} Turntable_Smoothing_t;
+extern Turntable_Smoothing_t dj_smoothing_left;
+extern Turntable_Smoothing_t dj_smoothing_right;
+// Feeds a new reading from a platter, this should be called once per poll
+void smoothTurntable(Turntable_Smoothing_t *smoothing, int8_t reading);
+// Returns the current smoothed value
+int8_t smoothedTurntable(Turntable_Smoothing_t *smoothing);
+#endif
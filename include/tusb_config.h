@@ -4,7 +4,8 @@
 #define CFG_TUSB_OS OPT_OS_PICO
 #define CFG_TUSB_RHPORT0_MODE (OPT_MODE_DEVICE)
 #define CFG_TUSB_RHPORT1_MODE (OPT_MODE_HOST)
-#define TUP_DCD_ENDPOINT_MAX 8
+// The rp2040 has 16 endpoints, and usb host passthrough interfaces use 10 and up
+#define TUP_DCD_ENDPOINT_MAX 16
 // Allow usb hubs
 #define CFG_TUH_DEVICE_MAX 8
 // RHPort max operational speed can defined by board.mk
@@ -0,0 +1,13 @@
+#pragma once
+#include <stdint.h>
+
+#include "config.h"
+#include "reports/controller_reports.h"
+// Every USB host device is decoded into its own USB_Host_Data_t, and those are merged into usb_host_data.
+// Buttons, keys and mouse buttons are combined from every device. Other values come from the last device
+// that has them away from rest, so an idle device never overwrites a value another device is holding.
+// A value of 0 counts as rest too, as that is what devices that don't have the value leave it at.
+
+// Sets every value to its resting value, ready for devices to be merged in
+void reset_usb_host_data(USB_Host_Data_t *out);
+void merge_usb_host_data(USB_Host_Data_t *out, const USB_Host_Data_t *in);
@@ -0,0 +1,78 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+// Per pad baseline tracking for the GHWT tap bar.
+// Baselines are kept in Q8 fixed point. Warmup lasts WT_WARMUP_MS, as the sample rate depends on
+// how the pads are read (the PIO reads them far faster than the peripheral loop does). For the
+// first WT_WARMUP samples the baseline is a running mean of everything seen, and for the rest of
+// the warmup it is an exponential mean over the same window. After that it only follows the pad
+// while it is untouched, slowly when the reading rises and quickly when it falls, so drift from
+// temperature and humidity is followed without a held tap being absorbed into the baseline.
+#define WT_WARMUP 256
+#define WT_WARMUP_MS 500
+#define WT_DRIFT_SHIFT 10
+#define WT_FALL_SHIFT 4
+#define WT_NOISE_SHIFT 4
+// A tap has to clear the sensitivity plus this many times the measured noise
+#define WT_NOISE_MARGIN 2
+
+typedef struct {
+    uint32_t baseline;
+    uint32_t noise;
+    uint32_t start;
+    uint16_t samples;
+    bool ready;
+    bool touched;
+} Wt_Baseline_t;
+
+static inline uint32_t wtBaseline(const Wt_Baseline_t* wt) {
+    return wt->baseline >> 8;
+}
+
+static inline uint32_t wtNoise(const Wt_Baseline_t* wt) {
+    return wt->noise >> 8;
+}
+
+static inline bool wtReady(const Wt_Baseline_t* wt) {
+    return wt->ready;
+}
+
+// now is the current time in milliseconds
+static inline bool wtUpdate(Wt_Baseline_t* wt, uint32_t value, uint32_t sensitivity, uint32_t now) {
+    int32_t sample = value << 8;
+    if (!wt->samples) {
+        // Seed the baseline from the first sample, otherwise the jump from zero would be counted as noise
+        wt->baseline = sample;
+        wt->noise = 0;
+        wt->samples = 1;
+        wt->start = now;
+        wt->ready = false;
+        wt->touched = false;
+        return false;
+    }
+    int32_t delta = sample - (int32_t)wt->baseline;
+    uint32_t deviation = delta < 0 ? -delta : delta;
+    if (!wtReady(wt)) {
+        if (wt->samples < WT_WARMUP) {
+            wt->samples++;
+        }
+        wt->baseline += delta / wt->samples;
+        wt->noise += ((int32_t)deviation - (int32_t)wt->noise) / wt->samples;
+        wt->touched = false;
+        wt->ready = wt->samples >= WT_WARMUP && now - wt->start >= WT_WARMUP_MS;
+        return false;
+    }
+    wt->touched = value > wtBaseline(wt) + sensitivity + wtNoise(wt) * WT_NOISE_MARGIN;
+    if (wt->touched) {
+        return true;
+    }
+    int32_t step = delta >> (delta < 0 ? WT_FALL_SHIFT : WT_DRIFT_SHIFT);
+    // Rising steps smaller than the shift would round to zero and leave the baseline a few counts low
+    if (!step && delta > 0) {
+        step = 1;
+    }
+    wt->baseline += step;
+    wt->noise += ((int32_t)deviation - (int32_t)wt->noise) >> WT_NOISE_SHIFT;
+    return false;
+}
@@ -38,6 +38,7 @@ typedef struct {
     uint8_t unknown;
     uint16_t state;
 } __attribute__((packed)) XBOX_WIRELESS_HEADER;
+#define XBOX_WIRELESS_INPUT_OFFSET 4
 
 typedef struct {
     uint8_t id;
@@ -161,4 +161,12 @@ uint16_t fxpt_asin(int16_t x) {
                          x2),
                  x) +
          x;
-}
\ No newline at end of file
+}
+int16_t fxpt_lowpass(const int16_t previous, const int32_t sample, const int16_t alpha) {
+  // saturate first so the products below can't overflow 32 bits
+  const int32_t x =
+      sample > INT16_MAX ? INT16_MAX : (sample < INT16_MIN ? INT16_MIN : sample);
+  // truncate towards zero, the same way the float to int conversion does
+  const int32_t y = x * alpha + (int32_t)previous * (32768 - alpha);
+  return y < 0 ? -((-y) >> 15) : y >> 15;
+}
@@ -47,6 +47,16 @@ extern "C" {
 #endif
 uint16_t fxpt_atan2(const int16_t y, const int16_t x);
 uint16_t fxpt_asin(int16_t x);
+/**
+ * Single pole low pass filter, y += alpha * (x - y), with alpha in Q15.
+ * Matches the floating point x * alpha + y * (1 - alpha) to within one LSB.
+ *
+ * @param previous last filter output
+ * @param sample new input, which may exceed 16 bits
+ * @param alpha filter coefficient in Q15, 32767 is (almost) no filtering
+ * @return new filter output, saturated to signed 16 bits
+ */
+int16_t fxpt_lowpass(const int16_t previous, const int32_t sample, const int16_t alpha);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,90 @@
+#!/usr/bin/env python3
+# Pulls deferred log records from a running controller and decodes them using the firmware ELF.
+# Usage: log_decode.py firmware.elf [--follow]
+# The firmware has to be built with logging enabled, e.g. -DLOG_LEVEL=LOG_LEVEL_INFO in build_flags.
+# Requires pyusb and pyelftools.
+import argparse
+import re
+import struct
+import time
+
+import usb.core
+from elftools.elf.elffile import ELFFile
+
+ARDWIINO_VID = 0x1209
+ARDWIINO_PID = 0x2882
+COMMAND_READ_LOG = 0x5C
+# Device to host, class, interface
+REQUEST_TYPE = 0xA1
+# Log_Record_t: format address, timestamp (us), four arguments
+RECORD = struct.Struct("<II4I")
+PRINTF = re.compile(r"%[-+ #0]*\d*(?:\.\d+)?l*([diuxXcsp%])")
+
+
+class FormatTable:
+    def __init__(self, path):
+        self.file = open(path, "rb")
+        self.elf = ELFFile(self.file)
+        self.cache = {}
+
+    def lookup(self, address):
+        if address in self.cache:
+            return self.cache[address]
+        for section in self.elf.iter_sections():
+            start = section["sh_addr"]
+            if section["sh_type"] == "SHT_NOBITS" or not start <= address < start + section["sh_size"]:
+                continue
+            data = section.data()[address - start:]
+            text = data[: data.index(b"\0")].decode("utf-8", "replace")
+            self.cache[address] = text
+            return text
+        return None
+
+
+def render(fmt, args):
+    args = iter(args)
+
+    def convert(match):
+        kind = match.group(1)
+        if kind == "%":
+            return "%"
+        value = next(args, 0)
+        if kind in "di":
+            value = struct.unpack("<i", struct.pack("<I", value))[0]
+        spec = match.group(0).replace("l", "")
+        if kind == "s" or kind == "p":
+            return hex(value)
+        return spec % value
+
+    return PRINTF.sub(convert, fmt)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("elf")
+    parser.add_argument("--vid", type=lambda x: int(x, 0), default=ARDWIINO_VID)
+    parser.add_argument("--pid", type=lambda x: int(x, 0), default=ARDWIINO_PID)
+    parser.add_argument("--follow", action="store_true")
+    args = parser.parse_args()
+    table = FormatTable(args.elf)
+    dev = usb.core.find(idVendor=args.vid, idProduct=args.pid)
+    if dev is None:
+        raise SystemExit("Controller not found")
+    while True:
+        data = bytes(dev.ctrl_transfer(REQUEST_TYPE, COMMAND_READ_LOG, 0, 0, 255))
+        if data and data[0]:
+            print(f"... {data[0]} records dropped")
+        for offset in range(1, len(data) - RECORD.size + 1, RECORD.size):
+            address, timestamp, *values = RECORD.unpack_from(data, offset)
+            fmt = table.lookup(address)
+            if fmt is None:
+                print(f"[{timestamp}] unknown format {address:#x} {values}")
+                continue
+            print(f"[{timestamp}] {render(fmt, values)}")
+        if not args.follow:
+            break
+        time.sleep(0.05)
+
+
+if __name__ == "__main__":
+    main()
@@ -4,6 +4,7 @@
 
 #include "Arduino.h"
 #include "config.h"
+#include "drum_trigger.h"
 #include "io_define.h"
 #include "progmem.h"
 #include "util.h"
@@ -12,6 +13,12 @@ volatile uint16_t adcReading[ADC_COUNT];
 const uint8_t analogPins[ADC_COUNT] = ADC_PINS;
 const uint16_t PROGMEM ports[PORT_COUNT] = PORTS;
 uint16_t adc(uint8_t pin) {
+#ifdef INPUT_DRUM_TRIGGER
+    // Piezo pads report the peak of their last hit while it is held, instead of whatever the pin happens to read now
+    if (DRUM_TRIGGER_MASK & (1 << pin)) {
+        return drumTriggerRead(pin);
+    }
+#endif
     return adcReading[pin];
 }
 
@@ -49,6 +56,14 @@ void digital_write(uint8_t port_num, uint8_t mask, uint8_t activeMask) {
     SREG = oldSREG;
 }
 
+void pin_init_pullup(uint8_t pin) {
+    pinMode(pin, INPUT_PULLUP);
+}
+
+bool pin_read(uint8_t pin) {
+    return digitalRead(pin);
+}
+
 uint16_t adc_read(uint8_t pin, uint8_t mask) {
 #if ADC_COUNT != 0
     cbi(ADCSRA, ADIE);
@@ -133,6 +148,11 @@ int currentAnalog = 0;
 #if ADC_COUNT != 0
 ISR(ADC_vect) {
     adcReading[currentAnalog] = ADC << 6;
+#ifdef INPUT_DRUM_TRIGGER
+    if (DRUM_TRIGGER_MASK & (1 << currentAnalog) && drumTriggerSample(currentAnalog, adcReading[currentAnalog])) {
+        drumTriggerHit(currentAnalog, micros());
+    }
+#endif
     currentAnalog++;
     if (currentAnalog == ADC_COUNT) {
         currentAnalog = 0;
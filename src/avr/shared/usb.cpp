@@ -9,6 +9,9 @@ USB_Device_Type_t get_device_address_for(uint8_t deviceType) {
 uint8_t transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength, uint8_t *buffer) {
     return 0;
 }
+bool queue_transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength, const uint8_t *buffer, usb_transfer_cb_t complete, uintptr_t user_data) {
+    return false;
+}
 #endif
 void authentication_successful() {
 }
\ No newline at end of file
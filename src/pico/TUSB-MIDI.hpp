@@ -4,10 +4,13 @@
 #include <MIDI.h>
 #include "TUSB-MIDI_defs.hpp"
 #include "tusb.h"
+#include "usb_midi_dispatch.h"
 
 namespace usbMidi {
 
-    class UsbMidiTransport {
+    // When any handler is set, received packets are decoded straight from the rx callback instead of
+    // being queued for MidiInterface::read(), which only handles one message per call
+    class UsbMidiTransport : public UsbMidiHandlers {
     private:
         byte mTxBuffer[4];
         size_t mTxIndex;
@@ -55,25 +58,28 @@ namespace usbMidi {
         void tuh_midi_rx_cb(uint8_t dev_addr, uint32_t num_packets) {
             if (midi_dev_addr != dev_addr) return;
 
-            while (num_packets > 0) {
-                --num_packets;
-                uint8_t bytes[4];
-                if (tuh_midi_packet_read(dev_addr, bytes)) {
-                    TU_LOG1("Read bytes %u %u %u %u\r\n", bytes[0], bytes[1], bytes[2], bytes[3]);
-
-                    midiEventPacket_t packet = {
-                            .header = bytes[0],
-                            .byte1 = bytes[1],
-                            .byte2 = bytes[2],
-                            .byte3 = bytes[3]
-                    };
-
-                    if(midiQueueIndex < MIDI_QUEUE_SIZE - 1) {
-                        midiQueue[midiQueueIndex] = packet;
-                        midiQueueIndex++;
-                    } else {
-                        TU_LOG1("Buffer overflow");
-                    }
+            // Drain everything the device sent, not just the count we were told about
+            uint8_t bytes[4];
+            while (tuh_midi_packet_read(dev_addr, bytes)) {
+                TU_LOG1("Read bytes %u %u %u %u\r\n", bytes[0], bytes[1], bytes[2], bytes[3]);
+
+                if (hasHandlers()) {
+                    dispatch(cableNumber, bytes);
+                    continue;
+                }
+
+                midiEventPacket_t packet = {
+                        .header = bytes[0],
+                        .byte1 = bytes[1],
+                        .byte2 = bytes[2],
+                        .byte3 = bytes[3]
+                };
+
+                if(midiQueueIndex < MIDI_QUEUE_SIZE - 1) {
+                    midiQueue[midiQueueIndex] = packet;
+                    midiQueueIndex++;
+                } else {
+                    TU_LOG1("Buffer overflow");
                 }
             }
         }
@@ -0,0 +1,211 @@
+#include "generic_hid.h"
+
+#include <string.h>
+
+static generic_plan_t generic_plans[GENERIC_PLAN_COUNT];
+
+bool generic_hid_wants_item(const HID_ReportItem_t *item) {
+    if (item->ItemType != HID_REPORT_ITEM_In)
+        return false;
+
+    switch (item->Attributes.Usage.Page) {
+        case GENERIC_USAGE_PAGE_DESKTOP:
+            switch (item->Attributes.Usage.Usage) {
+                case GENERIC_USAGE_X:
+                case GENERIC_USAGE_Y:
+                case GENERIC_USAGE_Z:
+                case GENERIC_USAGE_RX:
+                case GENERIC_USAGE_RY:
+                case GENERIC_USAGE_RZ:
+                case GENERIC_USAGE_SLIDER:
+                case GENERIC_USAGE_HAT_SWITCH:
+                case GENERIC_USAGE_DPAD_UP:
+                case GENERIC_USAGE_DPAD_DOWN:
+                case GENERIC_USAGE_DPAD_LEFT:
+                case GENERIC_USAGE_DPAD_RIGHT:
+                    return true;
+            }
+            return false;
+        case GENERIC_USAGE_PAGE_BUTTON:
+            // Plans only have room for buttons 1 - 16, keeping the rest would just use up the parser's report items
+            return item->Attributes.Usage.Usage >= 1 && item->Attributes.Usage.Usage <= 16;
+    }
+    return false;
+}
+
+static uint8_t generic_field_for(const HID_ReportItem_t *item) {
+    uint16_t usage = item->Attributes.Usage.Usage;
+    switch (item->Attributes.Usage.Page) {
+        case GENERIC_USAGE_PAGE_DESKTOP:
+            switch (usage) {
+                case GENERIC_USAGE_X:
+                    return GENERIC_FIELD_AXIS_X;
+                case GENERIC_USAGE_Y:
+                    return GENERIC_FIELD_AXIS_Y;
+                case GENERIC_USAGE_Z:
+                    return GENERIC_FIELD_AXIS_Z;
+                case GENERIC_USAGE_RX:
+                    return GENERIC_FIELD_AXIS_RX;
+                case GENERIC_USAGE_RY:
+                    return GENERIC_FIELD_AXIS_RY;
+                case GENERIC_USAGE_RZ:
+                    return GENERIC_FIELD_AXIS_RZ;
+                case GENERIC_USAGE_SLIDER:
+                    return GENERIC_FIELD_AXIS_SLIDER;
+                case GENERIC_USAGE_HAT_SWITCH:
+                    return GENERIC_FIELD_HAT;
+                case GENERIC_USAGE_DPAD_UP:
+                    return GENERIC_FIELD_DPAD_UP;
+                case GENERIC_USAGE_DPAD_RIGHT:
+                    return GENERIC_FIELD_DPAD_RIGHT;
+                case GENERIC_USAGE_DPAD_DOWN:
+                    return GENERIC_FIELD_DPAD_DOWN;
+                case GENERIC_USAGE_DPAD_LEFT:
+                    return GENERIC_FIELD_DPAD_LEFT;
+            }
+            break;
+        case GENERIC_USAGE_PAGE_BUTTON:
+            if (usage >= 1 && usage <= 16) {
+                return GENERIC_FIELD_BUTTON + usage - 1;
+            }
+            break;
+    }
+    return 0xFF;
+}
+
+generic_plan_t *compile_generic_plan(HID_ReportInfo_t *info) {
+    generic_plan_t *plan = NULL;
+    for (uint8_t i = 0; i < GENERIC_PLAN_COUNT; i++) {
+        if (!generic_plans[i].used) {
+            plan = &generic_plans[i];
+            break;
+        }
+    }
+    if (!plan || !info) {
+        return NULL;
+    }
+    memset(plan, 0, sizeof(generic_plan_t));
+    plan->using_report_ids = info->UsingReportIDs;
+    uint8_t total = 0;
+    // Add the fields for one report id at a time, in the order the ids first show up
+    for (HID_ReportItem_t *start = info->FirstReportItem; start; start = start->Next) {
+        bool seen = false;
+        for (uint8_t i = 0; i < plan->report_count; i++) {
+            if (plan->reports[i].report_id == start->ReportID) {
+                seen = true;
+                break;
+            }
+        }
+        if (seen) {
+            continue;
+        }
+        if (plan->report_count == GENERIC_PLAN_REPORTS) {
+            break;
+        }
+        generic_report_t *report = &plan->reports[plan->report_count];
+        report->report_id = start->ReportID;
+        report->first = total;
+        for (HID_ReportItem_t *item = start; item && total < GENERIC_PLAN_FIELDS; item = item->Next) {
+            if (item->ReportID != start->ReportID || item->ItemType != HID_REPORT_ITEM_In || !item->Attributes.BitSize || item->Attributes.BitSize > 32) {
+                continue;
+            }
+            uint8_t field = generic_field_for(item);
+            if (field == 0xFF) {
+                continue;
+            }
+            plan->fields[total].bit_offset = item->BitOffset;
+            plan->fields[total].bit_size = item->Attributes.BitSize;
+            plan->fields[total].field = field;
+            total++;
+        }
+        report->count = total - report->first;
+        if (report->count) {
+            plan->report_count++;
+        }
+    }
+    if (!plan->report_count) {
+        return NULL;
+    }
+    plan->used = true;
+    return plan;
+}
+
+static inline uint16_t scale_axis(uint32_t val, uint8_t size) {
+    if (size > 16) {
+        val >>= size - 16;
+    } else if (size < 16) {
+        val <<= 16 - size;
+    }
+    return val;
+}
+
+void decode_generic_report(const generic_plan_t *plan, const uint8_t *report, USB_Host_Data_t *out) {
+    memset(out, 0, sizeof(USB_Host_Data_t));
+    if (plan == NULL) {
+        return;
+    }
+    uint8_t report_id = 0;
+    if (plan->using_report_ids) {
+        report_id = *report++;
+    }
+    const generic_report_t *current = NULL;
+    for (uint8_t i = 0; i < plan->report_count; i++) {
+        if (plan->reports[i].report_id == report_id) {
+            current = &plan->reports[i];
+            break;
+        }
+    }
+    if (current == NULL) {
+        return;
+    }
+    const generic_field_t *field = &plan->fields[current->first];
+    for (uint8_t i = 0; i < current->count; i++, field++) {
+        uint32_t value = extract_bits(report, field->bit_offset, field->bit_size);
+        switch (field->field) {
+            case GENERIC_FIELD_AXIS_X:
+                out->genericAxisX = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_AXIS_Y:
+                out->genericAxisY = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_AXIS_Z:
+                out->genericAxisZ = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_AXIS_RX:
+                out->genericAxisRx = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_AXIS_RY:
+                out->genericAxisRy = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_AXIS_RZ:
+                out->genericAxisRz = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_AXIS_SLIDER:
+                out->genericAxisSlider = scale_axis(value, field->bit_size);
+                break;
+            case GENERIC_FIELD_HAT:
+                out->dpadLeft = value == 6 || value == 5 || value == 7;
+                out->dpadRight = value == 3 || value == 2 || value == 1;
+                out->dpadUp = value == 0 || value == 1 || value == 7;
+                out->dpadDown = value == 5 || value == 4 || value == 3;
+                break;
+            case GENERIC_FIELD_DPAD_UP:
+                out->dpadUp |= value != 0;
+                break;
+            case GENERIC_FIELD_DPAD_RIGHT:
+                out->dpadRight |= value != 0;
+                break;
+            case GENERIC_FIELD_DPAD_DOWN:
+                out->dpadDown |= value != 0;
+                break;
+            case GENERIC_FIELD_DPAD_LEFT:
+                out->dpadLeft |= value != 0;
+                break;
+            default:
+                if (value) {
+                    out->genericButtons |= 1 << (field->field - GENERIC_FIELD_BUTTON);
+                }
+                break;
+        }
+    }
+}
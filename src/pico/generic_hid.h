@@ -0,0 +1,80 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "hidparser.h"
+#include "reports/controller_reports.h"
+
+// Generic HID descriptors are compiled at mount into a flat list of fields to pull out of each report,
+// so decoding a report is just a shift and mask per field.
+#define GENERIC_PLAN_COUNT 8
+#define GENERIC_PLAN_FIELDS 48
+#define GENERIC_PLAN_REPORTS 8
+enum {
+    GENERIC_FIELD_AXIS_X,
+    GENERIC_FIELD_AXIS_Y,
+    GENERIC_FIELD_AXIS_Z,
+    GENERIC_FIELD_AXIS_RX,
+    GENERIC_FIELD_AXIS_RY,
+    GENERIC_FIELD_AXIS_RZ,
+    GENERIC_FIELD_AXIS_SLIDER,
+    GENERIC_FIELD_HAT,
+    GENERIC_FIELD_DPAD_UP,
+    GENERIC_FIELD_DPAD_RIGHT,
+    GENERIC_FIELD_DPAD_DOWN,
+    GENERIC_FIELD_DPAD_LEFT,
+    // Buttons 1 - 16 follow on from here
+    GENERIC_FIELD_BUTTON
+};
+typedef struct {
+    uint16_t bit_offset;
+    uint8_t bit_size;
+    uint8_t field;
+} generic_field_t;
+typedef struct {
+    uint8_t report_id;
+    uint8_t first;
+    uint8_t count;
+} generic_report_t;
+typedef struct generic_plan_s {
+    bool used;
+    bool using_report_ids;
+    uint8_t report_count;
+    generic_report_t reports[GENERIC_PLAN_REPORTS];
+    generic_field_t fields[GENERIC_PLAN_FIELDS];
+} generic_plan_t;
+
+// Usages that generic devices are decoded from, kept here so this doesn't depend on the TinyUSB HID headers
+#define GENERIC_USAGE_PAGE_DESKTOP 0x01
+#define GENERIC_USAGE_PAGE_BUTTON 0x09
+#define GENERIC_USAGE_X 0x30
+#define GENERIC_USAGE_Y 0x31
+#define GENERIC_USAGE_Z 0x32
+#define GENERIC_USAGE_RX 0x33
+#define GENERIC_USAGE_RY 0x34
+#define GENERIC_USAGE_RZ 0x35
+#define GENERIC_USAGE_SLIDER 0x36
+#define GENERIC_USAGE_HAT_SWITCH 0x39
+#define GENERIC_USAGE_DPAD_UP 0x90
+#define GENERIC_USAGE_DPAD_DOWN 0x91
+#define GENERIC_USAGE_DPAD_RIGHT 0x92
+#define GENERIC_USAGE_DPAD_LEFT 0x93
+
+// Report item filter for the HID parser, only input items that a plan can use are kept
+bool generic_hid_wants_item(const HID_ReportItem_t *item);
+// Turns the parsed descriptor into a plan grouped by report id. Returns NULL if there is nothing to decode or no room.
+generic_plan_t *compile_generic_plan(HID_ReportInfo_t *info);
+// Clears out, then fills in every field the plan has for the report id at the start of report
+void decode_generic_report(const generic_plan_t *plan, const uint8_t *report, USB_Host_Data_t *out);
+
+static inline uint32_t extract_bits(const uint8_t *data, uint16_t bit_offset, uint8_t bit_size) {
+    const uint8_t *start = data + (bit_offset >> 3);
+    uint8_t shift = bit_offset & 7;
+    uint8_t bytes = (shift + bit_size + 7) >> 3;
+    uint64_t raw = 0;
+    for (uint8_t i = 0; i < bytes; i++) {
+        raw |= (uint64_t)start[i] << (i * 8);
+    }
+    return (raw >> shift) & ((1ULL << bit_size) - 1);
+}
@@ -27,66 +27,40 @@
 #include "hidparser.h"
 #include <string.h>
 #include <stdbool.h>
-#include <assert.h>
-
-#ifdef DYNAMIC
-#include <malloc.h>
-#define ACQUIRE_AND_RELEASE(structure, size) \
-__attribute__ ((always_inline)) static inline structure##_t* acquire_##structure() { return malloc(sizeof(structure##_t)); } \
-__attribute__ ((always_inline)) static inline void release_##structure(structure##_t* pointer) { free(pointer); }
-#else
-#define ACQUIRE_AND_RELEASE(structure, size) \
-enum { MAX_##structure =  size }; \
-static structure##_t structure##s[MAX_##structure]; \
-static bool structure##sAcquired[MAX_##structure]; \
-static structure##_t* acquire_##structure() \
-{\
-	for(uint8_t i=0; i < MAX_##structure; i++) \
-	{\
-	if(!structure##sAcquired[i])\
-		{\
-			structure##sAcquired[i] = true;\
-			return &structure##s[i];\
-		}\
-	}\
-	assert(false);\
-	return NULL;\
-}\
-static void release_##structure(structure##_t* pointer)\
-{\
-	structure##sAcquired[pointer - structure##s] = false;\
+
+static HID_ReportItem_t *acquire_HID_ReportItem(HID_Parser_Arena_t *Arena)
+{
+	if (Arena->ReportInfo.TotalReportItems == HID_MAX_REPORTITEMS)
+		return NULL;
+	return &Arena->ReportItems[Arena->ReportInfo.TotalReportItems];
 }
-#endif
 
-ACQUIRE_AND_RELEASE(HID_ReportSizeInfo, 100);
-ACQUIRE_AND_RELEASE(HID_CollectionPath, 25);
-ACQUIRE_AND_RELEASE(HID_ReportInfo, 10);
-ACQUIRE_AND_RELEASE(HID_ReportItem, 50);
+static HID_CollectionPath_t *acquire_HID_CollectionPath(HID_Parser_Arena_t *Arena)
+{
+	if (Arena->TotalCollectionPaths == HID_MAX_COLLECTIONS)
+		return NULL;
+	return &Arena->CollectionPaths[Arena->TotalCollectionPaths++];
+}
 
-void USB_FreeReportInfo(HID_ReportInfo_t *ReportInfo)
+static HID_ReportSizeInfo_t *acquire_HID_ReportSizeInfo(HID_Parser_Arena_t *Arena)
 {
-	if (ReportInfo)
-	{
-		HID_ReportItem_t *item = ReportInfo->FirstReportItem;
-		while (item)
-		{
-			HID_ReportItem_t *current = item;
-			item = item->Next;
-			release_HID_ReportItem(current);
-		}
-		release_HID_ReportInfo(ReportInfo);
-	}
+	if (Arena->TotalReportIDSizes == HID_MAX_REPORT_IDS)
+		return NULL;
+	return &Arena->ReportIDSizes[Arena->TotalReportIDSizes++];
 }
 
-uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
+uint8_t USB_ProcessHIDReport(HID_Parser_Arena_t *Arena,
+							 const uint8_t *ReportData,
 							 uint16_t ReportSize,
 							 HID_ReportInfo_t **ParserDataOut)
 {
-	HID_ReportSizeInfo_t *FirstReportIDSize = acquire_HID_ReportSizeInfo();
-	HID_CollectionPath_t *FirstCollectionPath = acquire_HID_CollectionPath();
+	Arena->TotalCollectionPaths = 0;
+	Arena->TotalReportIDSizes = 0;
+	HID_ReportSizeInfo_t *FirstReportIDSize = acquire_HID_ReportSizeInfo(Arena);
+	HID_CollectionPath_t *FirstCollectionPath = acquire_HID_CollectionPath(Arena);
 	memset(FirstCollectionPath, 0, sizeof(HID_CollectionPath_t));
-	HID_ReportInfo_t *ParserData = acquire_HID_ReportInfo();
-	HID_StateTable_t StateTable[HID_STATETABLE_STACK_DEPTH];
+	HID_ReportInfo_t *ParserData = &Arena->ReportInfo;
+	HID_StateTable_t *StateTable = Arena->StateTable;
 	HID_StateTable_t *CurrStateTable = &StateTable[0];
 	HID_CollectionPath_t *CurrCollectionPath = NULL;
 	HID_ReportSizeInfo_t *CurrReportIDInfo = FirstReportIDSize;
@@ -218,8 +192,14 @@ uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
 
 					if (CurrReportIDInfo == NULL)
 					{
+						CurrReportIDInfo = acquire_HID_ReportSizeInfo(Arena);
+						if (CurrReportIDInfo == NULL)
+						{
+							Result = HID_PARSE_InsufficientReportIDItems;
+							break;
+						}
 						ParserData->TotalDeviceReports++;
-						iterator->Next = CurrReportIDInfo = acquire_HID_ReportSizeInfo();
+						iterator->Next = CurrReportIDInfo;
 						memset(CurrReportIDInfo, 0x00, sizeof(HID_ReportSizeInfo_t));
 					}
 				}
@@ -264,7 +244,12 @@ uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
 					{
 						CurrCollectionPath = CurrCollectionPath->Next;
 					}
-					HID_CollectionPath_t *NewCollectionPath = acquire_HID_CollectionPath();
+					HID_CollectionPath_t *NewCollectionPath = acquire_HID_CollectionPath(Arena);
+					if (NewCollectionPath == NULL)
+					{
+						Result = HID_PARSE_InsufficientCollectionPaths;
+						break;
+					}
 					CurrCollectionPath->Next = NewCollectionPath;
 					CurrCollectionPath = NewCollectionPath;
 					memset(CurrCollectionPath, 0, sizeof(HID_CollectionPath_t));
@@ -299,7 +284,6 @@ uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
 				CurrCollectionPath = CurrCollectionPath->Parent;
 				if (CurrCollectionPath)
 				{
-					release_HID_CollectionPath(CurrCollectionPath->Next);
 					CurrCollectionPath->Next = NULL;
 				}
 				break;
@@ -348,16 +332,21 @@ uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
 
 					if (!(ReportItemData & HID_IOF_CONSTANT) && CALLBACK_HIDParser_FilterHIDReportItem(&NewReportItem))
 					{
+						HID_ReportItem_t *NextReportItem = acquire_HID_ReportItem(Arena);
+						if (NextReportItem == NULL)
+						{
+							Result = HID_PARSE_InsufficientReportItems;
+							break;
+						}
 						if (!ParserData->FirstReportItem)
 						{
-							ParserData->FirstReportItem = acquire_HID_ReportItem();
-							ParserData->LastReportItem = ParserData->FirstReportItem;
+							ParserData->FirstReportItem = NextReportItem;
 						}
 						else
 						{
-							ParserData->LastReportItem->Next = acquire_HID_ReportItem();
-							ParserData->LastReportItem = ParserData->LastReportItem->Next;
+							ParserData->LastReportItem->Next = NextReportItem;
 						}
+						ParserData->LastReportItem = NextReportItem;
 						memcpy(ParserData->LastReportItem, &NewReportItem, sizeof(HID_ReportItem_t));
 						ParserData->LastReportItem->Next = NULL;
 						ParserData->TotalReportItems++;
@@ -381,32 +370,12 @@ uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
 		}
 	}
 
-	if (!(ParserData->TotalReportItems))
+	if (Result == HID_PARSE_Successful && !(ParserData->TotalReportItems))
 		Result = HID_PARSE_NoUnfilteredReportItems;
-	if (Result != HID_PARSE_Successful)
-	{
-		USB_FreeReportInfo(ParserData);
-	}
-	else
+	if (Result == HID_PARSE_Successful)
 	{
 		*ParserDataOut = ParserData;
 	}
-
-	HID_ReportSizeInfo_t *iteratorReportIDSizes = FirstReportIDSize;
-	while (iteratorReportIDSizes)
-	{
-		HID_ReportSizeInfo_t *temp = iteratorReportIDSizes->Next;
-		release_HID_ReportSizeInfo(iteratorReportIDSizes);
-		iteratorReportIDSizes = temp;
-	}
-
-	HID_CollectionPath_t *iteratorCollectionPaths = FirstCollectionPath;
-	while (iteratorCollectionPaths)
-	{
-		HID_CollectionPath_t *temp = iteratorCollectionPaths->Next;
-		release_HID_CollectionPath(iteratorCollectionPaths);
-		iteratorCollectionPaths = temp;
-	}
 	return Result;
 }
 
@@ -440,4 +409,10 @@ bool USB_GetHIDReportItemInfo(uint16_t report_id, const uint8_t *ReportData,
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+__attribute__((weak)) bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t *const CurrentItem)
+{
+	(void)CurrentItem;
+	return true;
+}
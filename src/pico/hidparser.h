@@ -85,12 +85,34 @@ extern "C"
 #if !defined(HID_USAGE_STACK_DEPTH) || defined(__DOXYGEN__)
 /** Constant indicating the maximum stack depth of the usage table. A larger usage table
  *  allows for more USAGE items to be indicated sequentially for REPORT COUNT entries of more than
- *  one, but requires more stack space. By default this is set to 8 levels (allowing for a report
- *  item with a count of 8) but this can be overridden by defining \c HID_USAGE_STACK_DEPTH to another
- *  value in the user project makefile, passing the define to the compiler using the -D compiler
- *  switch.
+ *  one, but requires more stack space. By default this is set to 16 levels (allowing for a report
+ *  item with a count of 16, PS3 controllers list 12 vendor usages in a row) but this can be overridden
+ *  by defining \c HID_USAGE_STACK_DEPTH to another value in the user project makefile, passing the
+ *  define to the compiler using the -D compiler switch.
+ */
+#define HID_USAGE_STACK_DEPTH 16
+#endif
+
+#if !defined(HID_MAX_REPORTITEMS) || defined(__DOXYGEN__)
+/** Constant indicating the maximum number of report items (IN, OUT or FEATURE) that can be kept in a
+ *  \ref HID_Parser_Arena_t. Items rejected by \ref CALLBACK_HIDParser_FilterHIDReportItem() do not count
+ *  towards this limit.
+ */
+#define HID_MAX_REPORTITEMS 50
+#endif
+
+#if !defined(HID_MAX_COLLECTIONS) || defined(__DOXYGEN__)
+/** Constant indicating the maximum number of COLLECTION items (nested or unnested) that can be
+ *  processed in a single report descriptor.
+ */
+#define HID_MAX_COLLECTIONS 25
+#endif
+
+#if !defined(HID_MAX_REPORT_IDS) || defined(__DOXYGEN__)
+/** Constant indicating the maximum number of unique report IDs that can be processed in a single
+ *  report descriptor.
  */
-#define HID_USAGE_STACK_DEPTH 8
+#define HID_MAX_REPORT_IDS 10
 #endif
 
 /** Returns the value a given HID report item (once its value has been fetched via \ref USB_GetHIDReportItemInfo())
@@ -163,6 +185,9 @@ extern "C"
 		HID_PARSE_UnexpectedEndCollection = 3,	   /**< An END COLLECTION item found without matching COLLECTION item. */
 		HID_PARSE_UsageListOverflow = 4,		   /**< More than \ref HID_USAGE_STACK_DEPTH usages listed in a row. */
 		HID_PARSE_NoUnfilteredReportItems = 5,	   /**< All report items from the device were filtered by the filtering callback routine. */
+		HID_PARSE_InsufficientReportItems = 6,	   /**< More than \ref HID_MAX_REPORTITEMS report items in the report. */
+		HID_PARSE_InsufficientCollectionPaths = 7, /**< More than \ref HID_MAX_COLLECTIONS collections in the report. */
+		HID_PARSE_InsufficientReportIDItems = 8,   /**< More than \ref HID_MAX_REPORT_IDS report IDs in the report. */
 	};
 
 	/* Private Interface - For use in library only: */
@@ -351,21 +376,26 @@ extern "C"
 	} HID_ReportInfo_t;
 
 	/* Function Prototypes: */
+	typedef struct HID_Parser_Arena_s HID_Parser_Arena_t;
+
 	/** Function to process a given HID report returned from an attached device, and store it into a given
 	 *  \ref HID_ReportInfo_t structure.
 	 *
+	 *  All parser output is placed in the given arena instead of being allocated, and stays valid until the
+	 *  arena is used for the next parse. Running out of room is reported through the return value.
+	 *
+	 *  \param[in]  Arena       Storage for the parser output, reset at the start of the parse.
 	 *  \param[in]  ReportData  Buffer containing the device's HID report table.
 	 *  \param[in]  ReportSize  Size in bytes of the HID report table.
 	 *  \param[out] ParserData  Pointer to a \ref HID_ReportInfo_t instance for the parser output.
 	 *
 	 *  \return A value in the \ref HID_Parse_ErrorCodes_t enum.
 	 */
-	uint8_t USB_ProcessHIDReport(const uint8_t *ReportData,
+	uint8_t USB_ProcessHIDReport(HID_Parser_Arena_t *Arena,
+								 const uint8_t *ReportData,
 								 uint16_t ReportSize,
 								 HID_ReportInfo_t **ParserData);
 
-	void USB_FreeReportInfo(HID_ReportInfo_t *ReportInfo);
-
 	/** Extracts the given report item's value out of the given HID report and places it into the Value
 	 *  member of the report item's \ref HID_ReportItem_t structure.
 	 *
@@ -382,7 +412,7 @@ extern "C"
 	bool USB_GetHIDReportItemInfo(uint16_t report_id, const uint8_t *ReportData,
 								  HID_ReportItem_t *const ReportItem);
 
-	/** Callback routine for the HID Report Parser. This callback <b>must</b> be implemented by the user code when
+	/** Callback routine for the HID Report Parser. This callback should be implemented by the user code when
 	 *  the parser is used, to determine what report IN, OUT and FEATURE item's information is stored into the user
 	 *  \ref HID_ReportInfo_t structure. This can be used to filter only those items the application will be using, so that
 	 *  no RAM is wasted storing the attributes for report items which will never be referenced by the application.
@@ -395,6 +425,9 @@ extern "C"
 	 *
 	 *  \return Boolean \c true if the item should be stored into the \ref HID_ReportInfo_t structure, \c false if
 	 *		  it should be ignored.
+	 *
+	 *  \note A weak default that keeps every item is provided, so builds that link the parser without using it
+	 *		(such as the native tests) still link.
 	 */
 	bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t *const CurrentItem);
 
@@ -417,6 +450,21 @@ extern "C"
 	} HID_StateTable_t;
 #endif
 
+	/** \brief HID Parser Arena Structure.
+	 *
+	 *  Fixed storage for everything the parser produces, so parsing never touches the heap.
+	 */
+	struct HID_Parser_Arena_s
+	{
+		HID_ReportInfo_t ReportInfo;
+		HID_ReportItem_t ReportItems[HID_MAX_REPORTITEMS];
+		HID_CollectionPath_t CollectionPaths[HID_MAX_COLLECTIONS];
+		HID_ReportSizeInfo_t ReportIDSizes[HID_MAX_REPORT_IDS];
+		HID_StateTable_t StateTable[HID_STATETABLE_STACK_DEPTH];
+		uint8_t TotalCollectionPaths;
+		uint8_t TotalReportIDSizes;
+	};
+
 	/* Disable C linkage for C++ Compilers: */
 #if defined(__cplusplus)
 }
@@ -14,6 +14,7 @@
 #include "pico/bootrom.h"
 #include "pico/stdlib.h"
 #include "pico_slave.h"
+#include "ps2.h"
 #include "wii.h"
 volatile bool spi_acknowledged = false;
 void spi_begin_output() {
@@ -247,33 +248,194 @@ void init_ack() {
 }
 #endif
 
+#if defined(INPUT_PS2) && PS2_PIO
+#include "hardware/dma.h"
+#include "hardware/pio.h"
+#include "psx.pio.h"
+// Unless the config overrides them, the PIO drives the pins that belong to the PS2 SPI block.
+// Pins are fixed to their SPI block on the rp2040, so the block is whichever one has pins assigned.
+#if !defined(PS2_CMD) || !defined(PS2_DAT) || !defined(PS2_CLK)
+#if defined(SPI_0_MOSI) && defined(SPI_0_MISO) && defined(SPI_0_SCK)
+#define PS2_SPI_0_PINS 1
+#else
+#define PS2_SPI_0_PINS 0
+#endif
+#if defined(SPI_1_MOSI) && defined(SPI_1_MISO) && defined(SPI_1_SCK)
+#define PS2_SPI_1_PINS 1
+#else
+#define PS2_SPI_1_PINS 0
+#endif
+#if PS2_SPI_0_PINS && PS2_SPI_1_PINS
+#error Both SPI blocks have pins, so PS2_CMD, PS2_DAT and PS2_CLK need to be set to pick the PS2 ones
+#elif PS2_SPI_0_PINS
+#define PS2_SPI_MOSI SPI_0_MOSI
+#define PS2_SPI_MISO SPI_0_MISO
+#define PS2_SPI_SCK SPI_0_SCK
+#elif PS2_SPI_1_PINS
+#define PS2_SPI_MOSI SPI_1_MOSI
+#define PS2_SPI_MISO SPI_1_MISO
+#define PS2_SPI_SCK SPI_1_SCK
+#else
+#error The PS2 SPI block has no MOSI, MISO and SCK pins, so PS2_CMD, PS2_DAT and PS2_CLK need to be set
+#endif
+#endif
+#ifndef PS2_CMD
+#define PS2_CMD PS2_SPI_MOSI
+#endif
+#ifndef PS2_DAT
+#define PS2_DAT PS2_SPI_MISO
+#endif
+#ifndef PS2_CLK
+#define PS2_CLK PS2_SPI_SCK
+#endif
+#define PS2_PHASE_IDLE 0
+#define PS2_PHASE_ATTENTION 1
+#define PS2_PHASE_HEADER 2
+#define PS2_PHASE_BODY 3
+static PIO ps2_pio;
+static uint ps2_sm;
+static uint ps2_dma_tx;
+static uint ps2_dma_rx;
+static uint8_t ps2_tx_len[PS2_PORT_COUNT];
+static uint8_t ps2_tx_buffer[PS2_PORT_COUNT][BUFFER_SIZE];
+static uint8_t ps2_rx_buffer[PS2_PORT_COUNT][BUFFER_SIZE];
+static uint8_t ps2_transfer_count;
+static volatile uint8_t ps2_current;
+static volatile uint8_t ps2_phase = PS2_PHASE_IDLE;
+static volatile bool ps2_reply_valid[PS2_PORT_COUNT];
+static void ps2_dma_start(uint8_t offset, uint8_t len) {
+    dma_channel_set_write_addr(ps2_dma_rx, ps2_rx_buffer[ps2_current] + offset, false);
+    dma_channel_set_trans_count(ps2_dma_rx, len, false);
+    dma_channel_set_read_addr(ps2_dma_tx, ps2_tx_buffer[ps2_current] + offset, false);
+    dma_channel_set_trans_count(ps2_dma_tx, len, false);
+    dma_start_channel_mask((1u << ps2_dma_tx) | (1u << ps2_dma_rx));
+}
+// Attention is dropped ATTN_DELAY before the first clock edge, and is held high
+// for ATTN_DELAY between frames, so each transfer goes through this alarm twice.
+static int64_t ps2_attention_alarm(alarm_id_t id, void *user_data) {
+    if (ps2_phase == PS2_PHASE_ATTENTION) {
+        INPUT_PS2_ATT_CLEAR();
+        ps2_phase = PS2_PHASE_HEADER;
+        return ATTN_DELAY;
+    }
+    ps2_dma_start(0, 3);
+    return 0;
+}
+// The header (port, id, 0x5A) is sent first, and once it arrives we know how long the rest of the reply is
+static void __not_in_flash_func(ps2_dma_irq)() {
+    if (!dma_channel_get_irq1_status(ps2_dma_rx)) {
+        return;
+    }
+    dma_channel_acknowledge_irq1(ps2_dma_rx);
+    uint8_t current = ps2_current;
+    if (ps2_phase == PS2_PHASE_HEADER) {
+        uint8_t len = ps2ReplyBodyLength(ps2_rx_buffer[current], ps2_tx_len[current]);
+        if (len) {
+            ps2_phase = PS2_PHASE_BODY;
+            ps2_dma_start(3, len);
+            return;
+        }
+    } else if (ps2_phase == PS2_PHASE_BODY) {
+        ps2_reply_valid[current] = true;
+    }
+    INPUT_PS2_ATT_SET();
+    if (current + 1 < ps2_transfer_count) {
+        // Move straight on to the next port in the sweep
+        ps2_current = current + 1;
+        ps2_phase = PS2_PHASE_ATTENTION;
+        add_alarm_in_us(ATTN_DELAY, ps2_attention_alarm, NULL, true);
+        return;
+    }
+    ps2_phase = PS2_PHASE_IDLE;
+}
+void ps2TransportInit(void) {
+    // The USB host stack also uses PIO, so use whichever block still has room
+    ps2_pio = pio_can_add_program(pio1, &psx_program) ? pio1 : pio0;
+    uint offset = pio_add_program(ps2_pio, &psx_program);
+    ps2_sm = pio_claim_unused_sm(ps2_pio, true);
+    psx_program_init(ps2_pio, ps2_sm, offset, PS2_CMD, PS2_DAT, PS2_CLK, PS2_ACK);
+
+    ps2_dma_tx = dma_claim_unused_channel(true);
+    ps2_dma_rx = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(ps2_dma_tx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(ps2_pio, ps2_sm, true));
+    dma_channel_configure(ps2_dma_tx, &c, &ps2_pio->txf[ps2_sm], ps2_tx_buffer, 0, false);
+
+    c = dma_channel_get_default_config(ps2_dma_rx);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, pio_get_dreq(ps2_pio, ps2_sm, false));
+    // Data is shifted in from the left, so the received byte is in the top byte of the FIFO
+    dma_channel_configure(ps2_dma_rx, &c, ps2_rx_buffer, (io_rw_8 *)&ps2_pio->rxf[ps2_sm] + 3, 0, false);
+    dma_channel_set_irq1_enabled(ps2_dma_rx, true);
+    irq_add_shared_handler(DMA_IRQ_1, ps2_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    INPUT_PS2_ATT_SET();
+}
+bool ps2TransportBusy(void) {
+    return ps2_phase != PS2_PHASE_IDLE;
+}
+void ps2TransportStart(const PS2Transfer_t *transfers, uint8_t count) {
+    if (ps2_phase != PS2_PHASE_IDLE || !count || count > PS2_PORT_COUNT) {
+        return;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        uint8_t len = transfers[i].len;
+        if (len >= BUFFER_SIZE) {
+            len = BUFFER_SIZE - 1;
+        }
+        memset(ps2_tx_buffer[i], 0x5A, BUFFER_SIZE);
+        ps2_tx_buffer[i][0] = transfers[i].port;
+        memcpy(ps2_tx_buffer[i] + 1, transfers[i].command, len);
+        ps2_tx_len[i] = len;
+        ps2_reply_valid[i] = false;
+    }
+    ps2_transfer_count = count;
+    ps2_current = 0;
+    ps2_phase = PS2_PHASE_HEADER;
+    INPUT_PS2_ATT_CLEAR();
+    // Give the controller time to notice attention before the first clock edge
+    add_alarm_in_us(ATTN_DELAY, ps2_attention_alarm, NULL, true);
+}
+uint8_t *ps2TransportReply(uint8_t index) {
+    return ps2_reply_valid[index] ? ps2_rx_buffer[index] : NULL;
+}
+#endif
+
 void read_serial(uint8_t *id, uint8_t len) {
     pico_get_unique_board_id_string((char *)id, len);
 }
 
 #ifdef INPUT_WT_NECK
+#include "hardware/pio.h"
+#include "wt.pio.h"
+#include "wt.h"
 
 #define WT_BUFFER 8
+// Discharge timeout, in PIO loop iterations (2 cycles each)
+#define WT_TIMEOUT 5000
+// Channel 6 isn't connected to a pad, and is measured at the start of each sweep
+// to drain whatever charge is left on the input
+static const uint8_t wtSequence[] = {6, 1, 0, 2, 3, 4};
+#define WT_SEQUENCE_LEN sizeof(wtSequence)
 uint32_t lastWt[5] = {0};
 uint32_t lastWtSum[5] = {0};
 uint32_t lastWtAvg[5][WT_BUFFER] = {0};
 uint8_t nextWt[5] = {0};
-uint32_t initialWt[5] = {0};
-uint32_t readWt(int pin) {
+Wt_Baseline_t wtBaselines[5] = {0};
+static PIO wt_pio;
+static uint wt_sm;
+static uint8_t wt_index = 0;
+static void selectWt(int pin) {
     gpio_put_masked((1 << WT_PIN_S0) | (1 << WT_PIN_S1) | (1 << WT_PIN_S2), ((pin & (1 << 0)) << WT_PIN_S0 - 0) | ((pin & (1 << 1)) << (WT_PIN_S1 - 1)) | ((pin & (1 << 2)) << (WT_PIN_S2 - 2)));
-    uint32_t m = rp2040.getCycleCount();
-    gpio_put(WT_PIN_INPUT, 1);
-    gpio_set_dir(WT_PIN_INPUT, true);
-    gpio_set_dir(WT_PIN_INPUT, false);
-    gpio_set_pulls(WT_PIN_INPUT, false, false);
-    while (gpio_get(WT_PIN_INPUT)) {
-        if (rp2040.getCycleCount() - m > 10000) {
-            break;
-        }
-    }
-    m = rp2040.getCycleCount() - m;
-    if (pin >= 6) {
-        return m;
+}
+static void storeWt(int pin, uint32_t m) {
+    if (pin >= 5) {
+        return;
     }
     lastWtSum[pin] -= lastWtAvg[pin][nextWt[pin]];
     lastWtAvg[pin][nextWt[pin]] = m;
@@ -282,36 +444,46 @@ uint32_t readWt(int pin) {
     if (nextWt[pin] >= WT_BUFFER) {
         nextWt[pin] = 0;
     }
-    m = lastWtSum[pin] / WT_BUFFER;
-    lastWt[pin] = m;
-    return m;
-}
-bool checkWt(int pin) {
-    return readWt(pin) > initialWt[pin];
+    lastWt[pin] = lastWtSum[pin] / WT_BUFFER;
+    wtUpdate(&wtBaselines[pin], lastWt[pin], WT_SENSITIVITY, millis());
 }
-void initWt() {
-    memset(initialWt, 0, sizeof(initialWt));
-    for (int j = 0; j < 1000; j++) {
-        for (int i = 0; i < 5; i++) {
-            initialWt[i] += readWt(i);
+// Timing is done by the PIO, so all that is left here is to store the result, move the mux
+// on to the next pad and start the next measurement. The mux pins are driven from SIO, which
+// DMA can't reach, so this is done from the PIO interrupt instead.
+static void __not_in_flash_func(wt_pio_irq)() {
+    while (!pio_sm_is_rx_fifo_empty(wt_pio, wt_sm)) {
+        uint32_t remaining = pio_sm_get(wt_pio, wt_sm);
+        storeWt(wtSequence[wt_index], (WT_TIMEOUT - remaining) * 2);
+        wt_index++;
+        if (wt_index >= WT_SEQUENCE_LEN) {
+            wt_index = 0;
         }
+        selectWt(wtSequence[wt_index]);
+        pio_sm_put(wt_pio, wt_sm, WT_TIMEOUT);
     }
-    for (int i = 0; i < 5; i++) {
-        initialWt[i] /= 1000;
-        initialWt[i] += WT_SENSITIVITY;
-    }
+}
+static void startWt() {
+    wt_pio = pio_can_add_program(pio1, &wt_program) ? pio1 : pio0;
+    uint offset = pio_add_program(wt_pio, &wt_program);
+    wt_sm = pio_claim_unused_sm(wt_pio, true);
+    wt_program_init(wt_pio, wt_sm, offset, WT_PIN_INPUT);
+    uint irq = wt_pio == pio0 ? PIO0_IRQ_1 : PIO1_IRQ_1;
+    pio_set_irq1_source_enabled(wt_pio, (pio_interrupt_source)(pis_sm0_rx_fifo_not_empty + wt_sm), true);
+    irq_add_shared_handler(irq, wt_pio_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(irq, true);
+    wt_index = 0;
+    selectWt(wtSequence[wt_index]);
+    pio_sm_put(wt_pio, wt_sm, WT_TIMEOUT);
+}
+bool checkWt(int pin) {
+    return wtBaselines[pin].touched;
 }
 static bool wtInit = false;
 uint8_t tickWt() {
     if (!wtInit) {
         wtInit = true;
-        initWt();
+        startWt();
     }
-    long m = micros();
-    readWt(6);
-    uint8_t ret = checkWt(1) | (checkWt(0) << 1) | (checkWt(2) << 2) | (checkWt(3) << 3) | (checkWt(4) << 4);
-    m = micros() - m;
-    printf("%d\r\n", m);
-    return ret;
+    return checkWt(1) | (checkWt(0) << 1) | (checkWt(2) << 2) | (checkWt(3) << 3) | (checkWt(4) << 4);
 }
 #endif
\ No newline at end of file
@@ -19,6 +19,7 @@
 #include "hidescriptorparser.h"
 #include "host/usbh_classdriver.h"
 #include "io.h"
+#include "log.h"
 #include "midi_host.h"
 #include "pico/bootrom.h"
 #include "pico/cyw43_arch.h"
@@ -27,13 +28,15 @@
 #include "reports/controller_reports.h"
 #include "serial.h"
 #include "shared_main.h"
+#include "usb_host_devices.h"
 #include "xinput_device.h"
 #include "xinput_host.h"
 #ifdef INPUT_USB_HOST
 #include "TUSB-MIDI.hpp"
 #endif
 
-CFG_TUSB_MEM_SECTION CFG_TUSB_MEM_ALIGN uint8_t buf[255];
+// Big enough for the xbox 360 configuration descriptor with every passthrough interface added
+CFG_TUSB_MEM_SECTION CFG_TUSB_MEM_ALIGN uint8_t buf[512];
 CFG_TUSB_MEM_SECTION CFG_TUSB_MEM_ALIGN uint8_t buf2[255];
 CFG_TUSB_MEM_SECTION CFG_TUSB_MEM_ALIGN STRING_DESCRIPTOR_PICO serialstring = {
     .bLength = (sizeof(uint8_t) + sizeof(uint8_t) + SERIAL_LEN),
@@ -48,17 +51,125 @@ bool connected = false;
 USB_Device_Type_t xone_dev_addr = {};
 USB_Device_Type_t x360_dev_addr = {};
 USB_Device_Type_t ps4_dev_addr = {};
-uint8_t total_usb_host_devices = 0;
-typedef struct {
-    USB_Device_Type_t type;
-    USB_LastReport_Data_t report;
-    uint8_t report_length;
-    bool switch_sent_timeout;
-    bool switch_sent_handshake;
-    uint8_t xone_init_id;
-} Usb_Host_Device_t;
-
-Usb_Host_Device_t usb_host_devices[CFG_TUH_DEVICE_MAX * CFG_TUH_XINPUT];
+#define RAPHNET_IDENTIFY_ATTEMPTS 10
+#define RAPHNET_IDENTIFY_INTERVAL 100
+
+static void tick_usb_transfers();
+static void drop_usb_transfers(uint8_t dev_addr);
+
+static void finish_usb_host_identify(Usb_Host_Device_t *device) {
+    uint8_t slot = device - usb_host_devices;
+    device->identify = USB_HOST_IDENTIFY_NONE;
+    device->changed = true;
+    if (device->type.console_type < USB_HOST_CONSOLE_TYPES) {
+        usb_host_devices_by_type[device->type.console_type] |= 1ULL << slot;
+    }
+    LOG_INFO("Identified %d on %d, %d. Sub type: %d", device->type.console_type, device->type.dev_addr, device->type.instance, device->type.sub_type);
+}
+
+static void usb_host_identify_complete(uint8_t dev_addr, bool success, const uint8_t *data, uint16_t len, uintptr_t user_data) {
+    Usb_Host_Device_t *device = &usb_host_devices[user_data & 0xFF];
+    // The device was unplugged and the slot reused while waiting
+    if (!device->used || device->generation != user_data >> 8 || !device->identify) {
+        return;
+    }
+    device->identify_waiting = false;
+    switch (device->identify) {
+        case USB_HOST_IDENTIFY_DEVICE: {
+            if (!success || len < sizeof(tusb_desc_device_t)) {
+                finish_usb_host_identify(device);
+                return;
+            }
+            tusb_desc_device_t *desc = (tusb_desc_device_t *)data;
+            if (device->type.console_type == SANTROLLER) {
+                device->type.sub_type = desc->bcdDevice >> 8;
+                finish_usb_host_identify(device);
+                return;
+            }
+            if (!desc->iProduct) {
+                finish_usb_host_identify(device);
+                return;
+            }
+            device->identify_product = desc->iProduct;
+            device->identify = USB_HOST_IDENTIFY_PRODUCT;
+            return;
+        }
+        case USB_HOST_IDENTIFY_PRODUCT: {
+            static const uint16_t wtProduct[] = {'G', 'u', 'i', 't', 'a', 'r', ' ', 'H', 'e', 'r', 'o', '4'};
+            // Skip over bLength and bDescriptorType
+            if (success && len >= sizeof(wtProduct) + 2 && !memcmp(wtProduct, data + 2, sizeof(wtProduct))) {
+                device->type.sub_type = GUITAR_HERO_GUITAR_WT;
+            }
+            finish_usb_host_identify(device);
+            return;
+        }
+        case USB_HOST_IDENTIFY_RAPHNET: {
+            device->identify_attempts++;
+            if (!success || len < 3 || !data[0]) {
+                if (device->identify_attempts >= RAPHNET_IDENTIFY_ATTEMPTS) {
+                    finish_usb_host_identify(device);
+                }
+                device->identify_at = millis() + RAPHNET_IDENTIFY_INTERVAL;
+                return;
+            }
+            switch (data[2]) {
+                case RNT_TYPE_PSX_DIGITAL:
+                case RNT_TYPE_PSX_ANALOG:
+                case RNT_TYPE_PSX_NEGCON:
+                case RNT_TYPE_PSX_MOUSE:
+                case RNT_TYPE_CLASSIC:
+                case RNT_TYPE_UDRAW_TABLET:
+                case RNT_TYPE_NUNCHUK:
+                case RNT_TYPE_CLASSIC_PRO:
+                    device->type.sub_type = GAMEPAD;
+                    break;
+                case RNT_TYPE_WII_GUITAR:
+                    device->type.sub_type = GUITAR_HERO_GUITAR;
+                    break;
+                case RNT_TYPE_WII_DRUM:
+                    device->type.sub_type = GUITAR_HERO_DRUMS;
+                    break;
+            }
+            finish_usb_host_identify(device);
+            return;
+        }
+    }
+}
+
+// Sends the next identification request for any device that is waiting on one. Everything else keeps running in the meantime
+static void tick_usb_host_identify() {
+    for (uint8_t i = 0; i < total_usb_host_devices; i++) {
+        Usb_Host_Device_t *device = &usb_host_devices[i];
+        if (!device->used || !device->identify || device->identify_waiting || (int32_t)(millis() - device->identify_at) < 0) {
+            continue;
+        }
+        uint8_t dev_addr = device->type.dev_addr;
+        uintptr_t user_data = i | (device->generation << 8);
+        bool queued = false;
+        switch (device->identify) {
+            case USB_HOST_IDENTIFY_DEVICE:
+                queued = queue_transfer_with_usb_controller(dev_addr, USB_SETUP_DEVICE_TO_HOST | USB_SETUP_TYPE_STANDARD | USB_SETUP_RECIPIENT_DEVICE, TUSB_REQ_GET_DESCRIPTOR, TUSB_DESC_DEVICE << 8, 0, sizeof(tusb_desc_device_t), NULL, usb_host_identify_complete, user_data);
+                break;
+            case USB_HOST_IDENTIFY_PRODUCT:
+                queued = queue_transfer_with_usb_controller(dev_addr, USB_SETUP_DEVICE_TO_HOST | USB_SETUP_TYPE_STANDARD | USB_SETUP_RECIPIENT_DEVICE, TUSB_REQ_GET_DESCRIPTOR, (TUSB_DESC_STRING << 8) | device->identify_product, 0x0409, USB_TRANSFER_MAX_LEN, NULL, usb_host_identify_complete, user_data);
+                break;
+            case USB_HOST_IDENTIFY_RAPHNET: {
+                static const uint8_t request[] = {0x06, 0x00, 0x00};
+                queued = queue_transfer_with_usb_controller(dev_addr, USB_SETUP_HOST_TO_DEVICE | USB_SETUP_TYPE_CLASS | USB_SETUP_RECIPIENT_INTERFACE, HID_REQUEST_SET_REPORT, 0x0300, 1, sizeof(request), request) &&
+                         queue_transfer_with_usb_controller(dev_addr, USB_SETUP_DEVICE_TO_HOST | USB_SETUP_TYPE_CLASS | USB_SETUP_RECIPIENT_INTERFACE, HID_REQUEST_GET_REPORT, 0x0300, 1, 3, NULL, usb_host_identify_complete, user_data);
+                break;
+            }
+        }
+        device->identify_waiting = queued;
+    }
+}
+
+uint64_t get_usb_host_devices_for(uint8_t console_type) {
+    if (console_type >= USB_HOST_CONSOLE_TYPES) {
+        return 0;
+    }
+    return usb_host_devices_by_type[console_type];
+}
 #endif
 typedef struct {
     uint8_t pin_dp;
@@ -91,6 +202,67 @@ bool usb_configured() {
 void send_report_to_pc(const void *report, uint8_t len) {
     tud_xusb_n_report(0, report, len);
 }
+#if USB_HOST_PASSTHROUGH
+static XInputGamepad_Data_t passthrough_reports[USB_HOST_PASSTHROUGH];
+
+static void fill_passthrough_report(uint8_t id, XInputGamepad_Data_t *report) {
+    memset(report, 0, sizeof(XInputGamepad_Data_t));
+    report->rsize = sizeof(XInputGamepad_Data_t);
+    USB_Device_Type_t type = get_usb_host_device_type(id);
+    if (type.console_type == NON_CONTROLLER || type.console_type == MIDI_ID) {
+        return;
+    }
+    // Xinput controllers already send xinput reports, so they go through untouched and instruments keep their layout
+    if ((type.console_type == XBOX360 || type.console_type == XBOX360_W) && usb_host_devices[id].report_length >= sizeof(XInputGamepad_Data_t)) {
+        memcpy(report, &usb_host_devices[id].report, sizeof(XInputGamepad_Data_t));
+        return;
+    }
+    USB_Host_Data_t *host = &usb_host_devices[id].decoded;
+    report->a = host->a;
+    report->b = host->b;
+    report->x = host->x;
+    report->y = host->y;
+    report->leftShoulder = host->leftShoulder;
+    report->rightShoulder = host->rightShoulder;
+    report->back = host->back;
+    report->start = host->start;
+    report->guide = host->guide;
+    report->leftThumbClick = host->leftThumbClick;
+    report->rightThumbClick = host->rightThumbClick;
+    report->dpadUp = host->dpadUp;
+    report->dpadDown = host->dpadDown;
+    report->dpadLeft = host->dpadLeft;
+    report->dpadRight = host->dpadRight;
+    report->leftTrigger = host->leftTrigger >> 8;
+    report->rightTrigger = host->rightTrigger >> 8;
+    report->leftStickX = host->leftStickX;
+    report->leftStickY = host->leftStickY;
+    report->rightStickX = host->rightStickX;
+    report->rightStickY = host->rightStickY;
+}
+
+// Every passthrough interface has its own endpoint, so each one is sent as soon as it is free
+// instead of waiting for the main report
+static void tick_usb_host_passthrough() {
+    if (consoleType != WINDOWS) {
+        return;
+    }
+    XInputGamepad_Data_t report;
+    for (uint8_t i = 0; i < USB_HOST_PASSTHROUGH; i++) {
+        uint8_t itf = tud_xinput_index(INTERFACE_ID_Passthrough + i);
+        if (itf == 0xFF || !tud_xinput_n_ready(itf)) {
+            continue;
+        }
+        fill_passthrough_report(i, &report);
+        if (!memcmp(&report, &passthrough_reports[i], sizeof(report))) {
+            continue;
+        }
+        if (tud_xusb_n_report(itf, &report, sizeof(report))) {
+            passthrough_reports[i] = report;
+        }
+    }
+}
+#endif
 bool foundXB = false;
 bool authReady = false;
 bool authDone = false;
@@ -111,6 +283,8 @@ static void tick_usb() {
 #endif
 #if USB_HOST_STACK
     tuh_task();
+    tick_usb_host_identify();
+    tick_usb_transfers();
 #endif
 #ifdef BLUETOOTH_RX
     // if connected to the transmitter, then run the bt based tick, otherwise run the usb based tick.
@@ -120,8 +294,12 @@ static void tick_usb() {
 #else
     tick();
 #endif
+#if USB_HOST_PASSTHROUGH
+    tick_usb_host_passthrough();
+#endif
 #ifdef INPUT_MIDI
-    MIDI.read();
+    // Packets are decoded as they arrive in tuh_midi_rx_cb, this just asks the device for more
+    usbMIDITransport.pollUsb();
 #endif
 #if BLUETOOTH
     if (!authDone) {
@@ -153,6 +331,10 @@ void loop1() {
 #endif
 void loop() {
     tick_usb();
+#if defined(LOG_PRINT) && LOG_LEVEL > LOG_LEVEL_NONE
+    // Logs are only formatted here, once the tick has been handled
+    logPrintPending();
+#endif
 }
 
 void setup() {
@@ -163,7 +345,7 @@ void setup() {
         consoleType = UNIVERSAL;
     }
     generateSerialString(&serialstring, consoleType);
-    printf("ConsoleType: %d\r\n", consoleType);
+    LOG_INFO("ConsoleType: %d", consoleType);
     init_main();
     tud_init(TUD_OPT_RHPORT);
 #if USB_HOST_STACK
@@ -174,10 +356,10 @@ void setup() {
     tuh_init(TUH_OPT_RHPORT);
 #ifdef INPUT_MIDI
     MIDI.begin(0);
-    MIDI.setHandleNoteOn(onNote);
-    MIDI.setHandleNoteOff(offNote);
-    MIDI.setHandleControlChange(onControlChange);
-    MIDI.setHandlePitchBend(onPitchBend);
+    usbMIDITransport.handleNoteOn = onNote;
+    usbMIDITransport.handleNoteOff = offNote;
+    usbMIDITransport.handleControlChange = onControlChange;
+    usbMIDITransport.handlePitchBend = onPitchBend;
 #endif
 #endif
 }
@@ -188,27 +370,26 @@ void tuh_midi_rx_cb(uint8_t dev_addr, uint32_t num_packets) {
 }
 
 void tuh_midi_mount_cb(uint8_t dev_addr, uint8_t in_ep, uint8_t out_ep, uint8_t num_cables_rx, uint16_t num_cables_tx) {
-    printf("MIDI device address = %u, IN endpoint %u has %u cables, OUT endpoint %u has %u cables\r\n",
-           dev_addr, in_ep & 0xf, num_cables_rx, out_ep & 0xf, num_cables_tx);
+    LOG_INFO("MIDI device address = %u, IN endpoint %u, OUT endpoint %u has %u cables", dev_addr, in_ep & 0xf, out_ep & 0xf, num_cables_rx);
 
     usbMIDITransport.midi_dev_addr = dev_addr;
 
     USB_Device_Type_t type = {MIDI_ID, 0, dev_addr, 0};
-    usb_host_devices[total_usb_host_devices].type = type;
-    total_usb_host_devices++;
+    add_usb_host_device(type);
 }
 
 // Invoked when device with hid interface is un-mounted
 void tuh_midi_umount_cb(uint8_t dev_addr, uint8_t instance) {
-    printf("MIDI device address = %d, instance = %d is unmounted\r\n", dev_addr, instance);
+    LOG_INFO("MIDI device address = %d, instance = %d is unmounted", dev_addr, instance);
 
     usbMIDITransport.midi_dev_addr = 0;
-    // Probably should actulaly work out what was unplugged and all that
-    total_usb_host_devices = 0;
+    // MIDI devices are always added as instance 0
+    remove_usb_host_device(dev_addr, 0);
+    drop_usb_transfers(dev_addr);
 }
 #endif
 void authentication_successful() {
-    printf("Auth done\r\n");
+    LOG_INFO("Auth done");
     authReady = true;
 }
 
@@ -240,8 +421,22 @@ uint8_t get_usb_host_device_count() {
     return total_usb_host_devices;
 }
 USB_Device_Type_t get_usb_host_device_type(uint8_t id) {
+    if (usb_host_devices[id].identify) {
+        return {NON_CONTROLLER, 0, usb_host_devices[id].type.dev_addr, usb_host_devices[id].type.instance};
+    }
     return usb_host_devices[id].type;
 }
+uint8_t get_usb_host_device_generation(uint8_t id) {
+    return usb_host_devices[id].generation;
+}
+bool take_usb_host_device_changed(uint8_t id) {
+    bool changed = usb_host_devices[id].changed;
+    usb_host_devices[id].changed = false;
+    return changed;
+}
+USB_Host_Data_t *get_usb_host_device_decoded(uint8_t id) {
+    return &usb_host_devices[id].decoded;
+}
 
 uint8_t get_usb_host_device_data(uint8_t id, uint8_t *buf) {
     if (usb_host_devices[id].type.console_type == GENERIC) {
@@ -259,95 +454,70 @@ uint8_t get_usb_host_device_data(uint8_t id, uint8_t *buf) {
 }
 
 uint8_t read_usb_host_devices(uint8_t *buf) {
+    uint8_t count = 0;
+    for (int i = 0; i < total_usb_host_devices; i++) {
+        if (!usb_host_devices[i].used) {
+            continue;
+        }
+        USB_Device_Type_t *type = &usb_host_devices[i].type;
+        buf[(count * 2)] = type->console_type;
+        buf[(count * 2) + 1] = type->sub_type;
+        count++;
+    }
+    return count * 2;
+}
+
+uint8_t read_usb_host_hid_status(uint8_t *buf) {
+    uint8_t count = 0;
     for (int i = 0; i < total_usb_host_devices; i++) {
+        if (!usb_host_devices[i].used) {
+            continue;
+        }
         USB_Device_Type_t *type = &usb_host_devices[i].type;
-        buf[(i * 2)] = type->console_type;
-        buf[(i * 2) + 1] = type->sub_type;
+        buf[count++] = tuh_xinput_hid_status(type->dev_addr, type->instance);
     }
-    return total_usb_host_devices * 2;
+    return count;
 }
 
 void tuh_xinput_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t console_type, uint8_t sub_type) {
-    printf("Detected controller: %d (%d) on %d, %d\r\n", console_type, sub_type, dev_addr, instance);
+    LOG_INFO("Detected controller: %d (%d) on %d, %d", console_type, sub_type, dev_addr, instance);
     uint16_t host_vid = 0;
     uint16_t host_pid = 0;
     tuh_vid_pid_get(dev_addr, &host_vid, &host_pid);
-    printf("%04x %04x\r\n", host_vid, host_pid);
+    LOG_INFO("%04x %04x", host_vid, host_pid);
     USB_Device_Type_t type = {console_type, sub_type, dev_addr, instance};
     get_usb_device_type_for(host_vid, host_pid, &type);
     switch (type.console_type) {
         case XBOX360:
             x360_dev_addr = type;
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
+            add_usb_host_device(type);
             xinput_controller_connected(host_vid, host_pid);
             if (consoleType == XBOX360) {
                 foundXB = true;
-                printf("found xb\r\n");
+                LOG_INFO("found xb");
             }
             break;
         case XBOX360_W:
             x360_dev_addr = type;
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
-            printf("found xb360 wireless\r\n");
+            add_usb_host_device(type);
+            LOG_INFO("found xb360 wireless");
             break;
         case XBOXONE:
             xone_dev_addr = type;
             xone_controller_connected(dev_addr, instance);
-            usb_host_devices[total_usb_host_devices].type = type;
-            usb_host_devices[total_usb_host_devices].xone_init_id = 0;
-            total_usb_host_devices++;
+            add_usb_host_device(type);
             if (consoleType == XBOXONE) {
                 foundXB = true;
             }
             break;
-        case SANTROLLER: {
-            tuh_descriptor_get_product_string_sync(dev_addr, 0, buf, sizeof(buf));
-            tuh_descriptor_get_device_sync(dev_addr, buf, sizeof(USB_DEVICE_DESCRIPTOR));
-            USB_DEVICE_DESCRIPTOR *desc = (USB_DEVICE_DESCRIPTOR *)buf;
-            type.sub_type = desc->bcdDevice >> 8;
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
-            printf("Found Santroller controller\r\n");
-            printf("Sub type: %d\r\n", type.sub_type);
+        case SANTROLLER:
+            add_usb_host_device(type, USB_HOST_IDENTIFY_DEVICE);
+            LOG_INFO("Found Santroller controller");
             break;
-        }
-        case RAPHNET: {
-            uint8_t data[] = {0x00, 0x00, 0x00};
-            uint8_t data2[] = {0x06, 0x00, 0x00};
-            for (int i = 0; i < 10; i++) {
-                transfer_with_usb_controller(dev_addr, USB_SETUP_HOST_TO_DEVICE | USB_SETUP_TYPE_CLASS | USB_SETUP_RECIPIENT_INTERFACE, HID_REQUEST_SET_REPORT, 0x0300, 1, 3, data2);
-                transfer_with_usb_controller(dev_addr, USB_SETUP_DEVICE_TO_HOST | USB_SETUP_TYPE_CLASS | USB_SETUP_RECIPIENT_INTERFACE, HID_REQUEST_GET_REPORT, 0x0300, 1, 3, data);
-                if (data[0]) {
-                    break;
-                }
-                sleep_ms(100);
-            }
-            switch (data[2]) {
-                case RNT_TYPE_PSX_DIGITAL:
-                case RNT_TYPE_PSX_ANALOG:
-                case RNT_TYPE_PSX_NEGCON:
-                case RNT_TYPE_PSX_MOUSE:
-                case RNT_TYPE_CLASSIC:
-                case RNT_TYPE_UDRAW_TABLET:
-                case RNT_TYPE_NUNCHUK:
-                case RNT_TYPE_CLASSIC_PRO:
-                    type.sub_type = GAMEPAD;
-                    break;
-                case RNT_TYPE_WII_GUITAR:
-                    type.sub_type = GUITAR_HERO_GUITAR;
-                    break;
-                case RNT_TYPE_WII_DRUM:
-                    type.sub_type = GUITAR_HERO_DRUMS;
-                    break;
-            }
-            printf("Found Raphnet controller\r\n");
-            printf("Sub type: %02x\r\n", type.sub_type);
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
+        case RAPHNET:
+            add_usb_host_device(type, USB_HOST_IDENTIFY_RAPHNET);
+            LOG_INFO("Found Raphnet controller");
             break;
-        }
         case XBOX360_BB:
         case KEYBOARD:
         case MOUSE:
@@ -359,42 +529,32 @@ void tuh_xinput_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t console_typ
         case STEPMANIAX:
         case LTEK:
         case LTEK_ID:
-            printf("Found Generic controller\r\n");
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
+            LOG_INFO("Found Generic controller");
+            add_usb_host_device(type);
             break;
         case PS3:
-            // GHWT and GH5 guitars have the same vid and pid, but different tap bar functions. We can read the device name to actually determine what it is
-            if (type.sub_type == GUITAR_HERO_GUITAR && XFER_RESULT_SUCCESS == tuh_descriptor_get_product_string_sync(dev_addr, 0, buf, sizeof(buf))) {
-                uint16_t wtProduct[] = {'G', 'u', 'i', 't', 'a', 'r', ' ', 'H', 'e', 'r', 'o', '4'};
-                if (memcmp(wtProduct, buf, sizeof(wtProduct)) || memcmp(wtProduct, buf + 1, sizeof(wtProduct))) {
-                    type.sub_type = GUITAR_HERO_GUITAR_WT;
-                }
-            }
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
-            printf("Found PS3 controller\r\n");
-            printf("Sub type: %d\r\n", type.sub_type);
+            add_usb_host_device(type, type.sub_type == GUITAR_HERO_GUITAR ? USB_HOST_IDENTIFY_DEVICE : USB_HOST_IDENTIFY_NONE);
+            LOG_INFO("Found PS3 controller");
+            LOG_INFO("Sub type: %d", type.sub_type);
             ps3_controller_connected(dev_addr, host_vid, host_pid);
             break;
         case PS4:
-            usb_host_devices[total_usb_host_devices].type = type;
-            total_usb_host_devices++;
+            add_usb_host_device(type);
             if (!ps4_dev_addr.dev_addr) {
                 ps4_dev_addr = type;
 
-                printf("Found PS4 controller\r\n");
+                LOG_INFO("Found PS4 controller");
                 ps4_controller_connected(dev_addr, host_vid, host_pid);
             }
             break;
     }
-    printf("Total devices: %d\r\n", total_usb_host_devices);
+    LOG_INFO("Total devices: %d", total_usb_host_devices);
 
     host_controller_connected();
 }
 
 void tuh_xinput_umount_cb(uint8_t dev_addr, uint8_t instance) {
-    printf("Unplugged %d\r\n", dev_addr);
+    LOG_INFO("Unplugged %d", dev_addr);
     if (xone_dev_addr.dev_addr == dev_addr && xone_dev_addr.instance == instance) {
         xone_dev_addr.dev_addr = 0;
     }
@@ -405,19 +565,16 @@ void tuh_xinput_umount_cb(uint8_t dev_addr, uint8_t instance) {
         ps4_dev_addr.dev_addr = 0;
         ps4_controller_disconnected();
     }
-    // Probably should actulaly work out what was unplugged and all that
-    total_usb_host_devices = 0;
+    remove_usb_host_device(dev_addr, instance);
+    drop_usb_transfers(dev_addr);
 }
 bool wasXb1Input = false;
 void tuh_xinput_report_sent_cb(uint8_t dev_addr, uint8_t instance, uint8_t const *report, uint16_t len) {
     // If there are xb1 init packets to send, send them
-    for (int i = 0; i < total_usb_host_devices; i++) {
-        if (usb_host_devices[i].type.dev_addr == dev_addr && usb_host_devices[i].type.instance == instance) {
-            if (usb_host_devices[i].type.console_type == XBOXONE) {
-                if (xone_controller_send_init_packet(dev_addr, instance, usb_host_devices[i].xone_init_id)) {
-                    usb_host_devices[i].xone_init_id++;
-                }
-            }
+    Usb_Host_Device_t *device = find_usb_host_device(dev_addr, instance);
+    if (device && device->type.console_type == XBOXONE) {
+        if (xone_controller_send_init_packet(dev_addr, instance, device->xone_init_id)) {
+            device->xone_init_id++;
         }
     }
 }
@@ -425,96 +582,99 @@ void tuh_xinput_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t c
     if (dev_addr == xone_dev_addr.dev_addr && instance == xone_dev_addr.instance) {
         receive_report_from_controller(report, len);
     }
-    for (int i = 0; i < total_usb_host_devices; i++) {
-        if (usb_host_devices[i].type.dev_addr == dev_addr && usb_host_devices[i].type.instance == instance) {
-            if (usb_host_devices[i].type.console_type == XBOXONE) {
-                GipHeader_t *header = (GipHeader_t *)report;
-                if (header->command == GIP_VIRTUAL_KEYCODE) {
-                    GipKeystroke_t *keystroke = (GipKeystroke_t *)report;
-                    if (wasXb1Input) {
-                        XboxOneInputHeader_Data_t *gamepad = (XboxOneInputHeader_Data_t *)(&(usb_host_devices[i].report));
-                        gamepad->guide = keystroke->pressed;
-                    }
-                    return;
-                }
-                if (header->command != GHL_HID_REPORT && header->command != GIP_INPUT_REPORT) {
-                    return;
-                }
-                wasXb1Input = header->command == GIP_INPUT_REPORT;
-            }
-            if (usb_host_devices[i].type.console_type == XBOX360_W) {
-                XBOX_WIRELESS_HEADER *header = (XBOX_WIRELESS_HEADER *)report;
-                if (header->id == 0x08) {
-                    // Disconnected
-                    if (header->type == 0x00) {
-                        usb_host_devices[i].type.sub_type = UNKNOWN;
-                    }
-                } else if (header->id == 0x00) {
-                    // Gamepad inputs
-                    if (header->type == 0x01 || header->type == 0x03) {
-                        memcpy(&usb_host_devices[i].report, report + sizeof(header), len - sizeof(header));
-                        usb_host_devices[i].report_length = len - sizeof(header);
-                    }
-                    // Link report
-                    if (header->type == 0x0f) {
-                        XBOX_WIRELESS_LINK_REPORT *linkReport = (XBOX_WIRELESS_LINK_REPORT *)report;
-                        if (linkReport->always_0xCC != 0xCC) {
-                            return;
-                        }
-                        uint8_t sub_type = linkReport->subtype & ~0x80;
-                        usb_host_devices[i].type.sub_type = sub_type;
-                        printf("Found subtype: %02x %02x %02x\r\n", sub_type, dev_addr, instance);
-                        xinput_w_controller_connected();
-                        // Request capabilities so we can figure out WT guitars
-                        if (sub_type == XINPUT_GUITAR_ALTERNATE) {
-                            // request capabilities
-                            send_report_to_controller(dev_addr, instance, capabilitiesRequest, sizeof(capabilitiesRequest));
-                        }
-                    }
-                    if (header->type == 0x05) {
-                        XBOX_WIRELESS_CAPABILITIES *caps = (XBOX_WIRELESS_CAPABILITIES *)report;
-                        if (caps->always_0x12 != 0x12) {
-                            return;
-                        }
-                        printf("Found capabilities: %02x %02x\r\n", dev_addr, instance);
-                        if (caps->leftStickX == 0xFFC0 && caps->rightStickX == 0xFFC0) {
-                            usb_host_devices[i].type.sub_type = XINPUT_GUITAR_WT;
-                            printf("Found wt\r\n");
-                        }
-                    }
-                }
-                return;
+    Usb_Host_Device_t *device = find_usb_host_device(dev_addr, instance);
+    if (!device) {
+        return;
+    }
+    // Anything below can change what this device decodes to, so always decode it again
+    device->changed = true;
+    if (device->type.console_type == XBOXONE) {
+        GipHeader_t *header = (GipHeader_t *)report;
+        if (header->command == GIP_VIRTUAL_KEYCODE) {
+            GipKeystroke_t *keystroke = (GipKeystroke_t *)report;
+            if (wasXb1Input) {
+                XboxOneInputHeader_Data_t *gamepad = (XboxOneInputHeader_Data_t *)(&(device->report));
+                gamepad->guide = keystroke->pressed;
             }
-            if (usb_host_devices[i].type.console_type == STREAM_DECK && report[0] != STREAM_DECK_INPUT_REPORT_ID) {
-                continue;
+            return;
+        }
+        if (header->command != GHL_HID_REPORT && header->command != GIP_INPUT_REPORT) {
+            return;
+        }
+        wasXb1Input = header->command == GIP_INPUT_REPORT;
+    }
+    // Each receiver interface is its own controller, with its own slot, sub type and outputs
+    if (device->type.console_type == XBOX360_W) {
+        XBOX_WIRELESS_HEADER *header = (XBOX_WIRELESS_HEADER *)report;
+        if (header->id == 0x08) {
+            // Disconnected, drop the last report so the controller stops feeding the merged inputs
+            if (header->type == 0x00) {
+                device->type.sub_type = UNKNOWN;
+                device->report_length = 0;
             }
-            if (usb_host_devices[i].type.console_type == PS5 && report[0] != PS5_INPUT_REPORT_ID) {
-                continue;
+        } else if (header->id == 0x00) {
+            // Gamepad inputs, a normal xinput report follows the receiver header
+            if ((header->type == 0x01 || header->type == 0x03) && len > XBOX_WIRELESS_INPUT_OFFSET) {
+                memcpy(&device->report, report + XBOX_WIRELESS_INPUT_OFFSET, len - XBOX_WIRELESS_INPUT_OFFSET);
+                device->report_length = len - XBOX_WIRELESS_INPUT_OFFSET;
             }
-            if (usb_host_devices[i].type.console_type == STEPMANIAX && report[0] != STEPMANIA_X_REPORT_ID) {
-                continue;
+            // Link report
+            if (header->type == 0x0f) {
+                XBOX_WIRELESS_LINK_REPORT *linkReport = (XBOX_WIRELESS_LINK_REPORT *)report;
+                if (linkReport->always_0xCC != 0xCC) {
+                    return;
+                }
+                uint8_t sub_type = linkReport->subtype & ~0x80;
+                device->type.sub_type = sub_type;
+                LOG_INFO("Found subtype: %02x %02x %02x", sub_type, dev_addr, instance);
+                xinput_w_controller_connected(dev_addr, instance);
+                // Request capabilities so we can figure out WT guitars
+                if (sub_type == XINPUT_GUITAR_ALTERNATE) {
+                    // request capabilities
+                    send_report_to_controller(dev_addr, instance, capabilitiesRequest, sizeof(capabilitiesRequest));
+                }
             }
-            if (usb_host_devices[i].type.console_type == SWITCH) {
-                if (usb_host_devices[i].type.console_type == SWITCH && !usb_host_devices[i].switch_sent_handshake) {
-                    usb_host_devices[i].switch_sent_handshake = true;
-                    uint8_t buf[2] = {0x80 /* PROCON_REPORT_SEND_USB */, 0x02 /* PROCON_USB_HANDSHAKE */};
-                    send_report_to_controller(dev_addr, instance, buf, 2);
-                } else if (usb_host_devices[i].type.console_type == SWITCH && !usb_host_devices[i].switch_sent_timeout) {
-                    usb_host_devices[i].switch_sent_timeout = true;
-                    uint8_t buf[2] = {0x80 /* PROCON_REPORT_SEND_USB */, 0x04 /* PROCON_USB_ENABLE */};
-                    send_report_to_controller(dev_addr, instance, buf, 2);
+            if (header->type == 0x05) {
+                XBOX_WIRELESS_CAPABILITIES *caps = (XBOX_WIRELESS_CAPABILITIES *)report;
+                if (caps->always_0x12 != 0x12) {
+                    return;
                 }
-
-                if (report[0] != SWITCH_PRO_CON_FULL_REPORT_ID) {
-                    continue;
+                LOG_INFO("Found capabilities: %02x %02x", dev_addr, instance);
+                if (caps->leftStickX == 0xFFC0 && caps->rightStickX == 0xFFC0) {
+                    device->type.sub_type = XINPUT_GUITAR_WT;
+                    LOG_INFO("Found wt");
                 }
             }
+        }
+        return;
+    }
+    if (device->type.console_type == STREAM_DECK && report[0] != STREAM_DECK_INPUT_REPORT_ID) {
+        return;
+    }
+    if (device->type.console_type == PS5 && report[0] != PS5_INPUT_REPORT_ID) {
+        return;
+    }
+    if (device->type.console_type == STEPMANIAX && report[0] != STEPMANIA_X_REPORT_ID) {
+        return;
+    }
+    if (device->type.console_type == SWITCH) {
+        if (device->type.console_type == SWITCH && !device->switch_sent_handshake) {
+            device->switch_sent_handshake = true;
+            uint8_t buf[2] = {0x80 /* PROCON_REPORT_SEND_USB */, 0x02 /* PROCON_USB_HANDSHAKE */};
+            send_report_to_controller(dev_addr, instance, buf, 2);
+        } else if (device->type.console_type == SWITCH && !device->switch_sent_timeout) {
+            device->switch_sent_timeout = true;
+            uint8_t buf[2] = {0x80 /* PROCON_REPORT_SEND_USB */, 0x04 /* PROCON_USB_ENABLE */};
+            send_report_to_controller(dev_addr, instance, buf, 2);
+        }
 
-            memcpy(&usb_host_devices[i].report, report, len);
-            usb_host_devices[i].report_length = len;
+        if (report[0] != SWITCH_PRO_CON_FULL_REPORT_ID) {
             return;
         }
     }
+
+    memcpy(&device->report, report, len);
+    device->report_length = len;
 }
 
 usbh_class_driver_t driver_host[] = {
@@ -567,11 +727,149 @@ uint16_t const *tud_descriptor_string_cb(uint8_t index, uint16_t langid) {
     return NULL;
 }
 
+#if USB_HOST_STACK
+enum {
+    USB_TRANSFER_FREE,
+    USB_TRANSFER_PENDING,
+    USB_TRANSFER_IN_FLIGHT
+};
+typedef struct {
+    tusb_control_request_t setup;
+    uint8_t state;
+    // Transfers go out oldest first
+    uint16_t order;
+    usb_transfer_cb_t complete;
+    uintptr_t user_data;
+    CFG_TUSB_MEM_ALIGN uint8_t data[USB_TRANSFER_MAX_LEN];
+} Usb_Transfer_t;
+CFG_TUSB_MEM_SECTION static Usb_Transfer_t usb_transfers[CFG_TUH_DEVICE_MAX][USB_TRANSFER_QUEUE];
+static Usb_Transfer_t *usb_transfer_in_flight = NULL;
+static uint16_t usb_transfer_order = 0;
+
+static void usb_transfer_complete(tuh_xfer_t *xfer) {
+    Usb_Transfer_t *transfer = (Usb_Transfer_t *)xfer->user_data;
+    // The device may have been unplugged and its queue dropped while this was in flight
+    if (transfer != usb_transfer_in_flight) {
+        return;
+    }
+    usb_transfer_in_flight = NULL;
+    transfer->state = USB_TRANSFER_FREE;
+    if (transfer->complete) {
+        transfer->complete(xfer->daddr, xfer->result == XFER_RESULT_SUCCESS, transfer->data, xfer->actual_len, transfer->user_data);
+    }
+}
+
+bool queue_transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength, const uint8_t *buffer, usb_transfer_cb_t complete, uintptr_t user_data) {
+    if (!dev_addr || dev_addr > CFG_TUH_DEVICE_MAX || wLength > USB_TRANSFER_MAX_LEN) {
+        return false;
+    }
+    Usb_Transfer_t *queue = usb_transfers[dev_addr - 1];
+    Usb_Transfer_t *transfer = NULL;
+    bool out = !(requestType & USB_SETUP_DEVICE_TO_HOST);
+    for (uint8_t i = 0; i < USB_TRANSFER_QUEUE; i++) {
+        Usb_Transfer_t *current = &queue[i];
+        // Rumble and LED updates for the same report replace the one still waiting, only the latest matters
+        if (out && current->state == USB_TRANSFER_PENDING && current->setup.bmRequestType == requestType && current->setup.bRequest == request && current->setup.wValue == wValue && current->setup.wIndex == wIndex) {
+            transfer = current;
+            break;
+        }
+        if (!transfer && current->state == USB_TRANSFER_FREE) {
+            transfer = current;
+        }
+    }
+    if (!transfer) {
+        LOG_DEBUG("Transfer queue full for %d", dev_addr);
+        return false;
+    }
+    if (transfer->state == USB_TRANSFER_FREE) {
+        transfer->order = usb_transfer_order++;
+    }
+    transfer->setup = {
+        bmRequestType : requestType,
+        bRequest : request,
+        wValue : wValue,
+        wIndex : wIndex,
+        wLength : wLength
+    };
+    if (out && buffer) {
+        memcpy(transfer->data, buffer, wLength);
+    }
+    transfer->complete = complete;
+    transfer->user_data = user_data;
+    transfer->state = USB_TRANSFER_PENDING;
+    return true;
+}
+
+// Control transfers share the host's control pipe, so they are sent one at a time from the main loop
+static void tick_usb_transfers() {
+    if (usb_transfer_in_flight) {
+        return;
+    }
+    Usb_Transfer_t *next = NULL;
+    uint8_t next_addr = 0;
+    for (uint8_t dev = 0; dev < CFG_TUH_DEVICE_MAX; dev++) {
+        for (uint8_t i = 0; i < USB_TRANSFER_QUEUE; i++) {
+            Usb_Transfer_t *transfer = &usb_transfers[dev][i];
+            if (transfer->state != USB_TRANSFER_PENDING) {
+                continue;
+            }
+            if (!next || (int16_t)(transfer->order - next->order) < 0) {
+                next = transfer;
+                next_addr = dev + 1;
+            }
+        }
+    }
+    if (!next) {
+        return;
+    }
+    tuh_xfer_t xfer = {};
+    xfer.daddr = next_addr;
+    xfer.ep_addr = 0;
+    xfer.setup = &next->setup;
+    xfer.buffer = next->data;
+    xfer.complete_cb = usb_transfer_complete;
+    xfer.user_data = (uintptr_t)next;
+    next->state = USB_TRANSFER_IN_FLIGHT;
+    usb_transfer_in_flight = next;
+    if (!tuh_control_xfer(&xfer)) {
+        // Control pipe is busy (probably enumeration), try again next tick
+        next->state = USB_TRANSFER_PENDING;
+        usb_transfer_in_flight = NULL;
+    }
+}
+
+static void drop_usb_transfers(uint8_t dev_addr) {
+    if (!dev_addr || dev_addr > CFG_TUH_DEVICE_MAX) {
+        return;
+    }
+    for (uint8_t i = 0; i < USB_TRANSFER_QUEUE; i++) {
+        Usb_Transfer_t *transfer = &usb_transfers[dev_addr - 1][i];
+        if (transfer == usb_transfer_in_flight) {
+            usb_transfer_in_flight = NULL;
+        }
+        transfer->state = USB_TRANSFER_FREE;
+    }
+}
+#endif
+
+// Blocking control transfer, for requests that need the answer straight away.
+// Queued transfers only start from tick_usb, so none can start while this runs, but one already in flight
+// has to finish first as the control pipe only takes one transfer at a time.
 uint8_t transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength, uint8_t *buffer) {
     if (!dev_addr) {
         // Device is not connected yet!
         return 0;
     }
+#if USB_HOST_STACK
+    uint32_t start = millis();
+    while (usb_transfer_in_flight) {
+        if (millis() - start > USB_TRANSFER_WAIT_MS) {
+            LOG_DEBUG("Queued transfer still in flight, dropping request for %d", dev_addr);
+            return 0;
+        }
+        tuh_task();
+    }
+#endif
     tusb_control_request_t setup = {
         bmRequestType : requestType,
         bRequest : request,
@@ -586,12 +884,14 @@ uint8_t transfer_with_usb_controller(const uint8_t dev_addr, const uint8_t reque
     xfer.buffer = buffer;
     xfer.complete_cb = NULL;
     xfer.user_data = 0;
-    tuh_control_xfer(&xfer);
-    if (xfer.result != XFER_RESULT_SUCCESS) {
-        return false;
+    // Only written once the transfer completes, so a request that never went out must not read as a success
+    xfer.result = XFER_RESULT_FAILED;
+    if (!tuh_control_xfer(&xfer) || xfer.result != XFER_RESULT_SUCCESS) {
+        return 0;
     }
     return xfer.actual_len;
 }
+
 tusb_control_request_t lastreq;
 bool tud_vendor_control_xfer_cb(uint8_t rhport, uint8_t stage, tusb_control_request_t const *request) {
     if (request->bmRequestType_bit.type == TUSB_REQ_TYPE_STANDARD && request->bRequest == TUSB_REQ_GET_DESCRIPTOR) {
@@ -1,22 +1,106 @@
 #include <hardware/adc.h>
+#include <hardware/dma.h>
 #include <hardware/gpio.h>
+#include <hardware/irq.h>
 #include <stdint.h>
 
 #include "Arduino.h"
 #include "config.h"
+#include "drum_trigger.h"
 #include "io_define.h"
 #include "pin_funcs.h"
 #include "util.h"
 uint16_t adcReading[NUM_ANALOG_INPUTS];
 bool first = true;
+#ifdef INPUT_DRUM_TRIGGER
+// The ADC free runs over every input, and DMA fills one block while the other is being scanned.
+// Each block holds whole sweeps, so a sample's position tells us which input it came from.
+#define DRUM_TRIGGER_BLOCK (DRUM_TRIGGER_CHANNELS * 8)
+static uint16_t drumBlocks[2][DRUM_TRIGGER_BLOCK];
+static uint8_t drumBlock = 0;
+static int drumDma = -1;
+static void drum_dma_start() {
+    dma_channel_transfer_to_buffer_now(drumDma, drumBlocks[drumBlock], DRUM_TRIGGER_BLOCK);
+}
+static void drum_adc_start();
+static void drum_adc_stop();
+static void __not_in_flash_func(drum_dma_irq)() {
+    if (!(dma_hw->ints1 & (1u << drumDma))) {
+        return;
+    }
+    dma_hw->ints1 = 1u << drumDma;
+    if (adc_hw->fcs & ADC_FCS_OVER_BITS) {
+        // A sample was dropped, so positions in the block no longer line up with inputs.
+        // Throw the block away and start again from input 0.
+        drum_adc_stop();
+        hw_set_bits(&adc_hw->fcs, ADC_FCS_OVER_BITS);
+        drum_adc_start();
+        return;
+    }
+    uint16_t *block = drumBlocks[drumBlock];
+    drumBlock = !drumBlock;
+    drum_dma_start();
+    for (uint i = 0; i < DRUM_TRIGGER_BLOCK; i++) {
+        uint8_t channel = i % DRUM_TRIGGER_CHANNELS;
+        uint16_t value = block[i] << 4;
+        adcReading[channel] = value;
+        if (DRUM_TRIGGER_MASK & (1 << channel) && drumTriggerSample(channel, value)) {
+            drumTriggerHit(channel, micros());
+        }
+    }
+}
+static void drum_adc_start() {
+    adc_select_input(0);
+    adc_fifo_drain();
+    drumBlock = 0;
+    drum_dma_start();
+    adc_run(true);
+}
+// One off reads need the ADC to themselves, so the free running conversion is paused around them
+static void drum_adc_stop() {
+    adc_run(false);
+    dma_channel_abort(drumDma);
+    while (!(adc_hw->cs & ADC_CS_READY_BITS)) {
+        tight_loop_contents();
+    }
+    adc_fifo_drain();
+}
+static void drum_adc_init() {
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_round_robin((1 << DRUM_TRIGGER_CHANNELS) - 1);
+    adc_set_clkdiv(48000000.0f / (DRUM_TRIGGER_RATE * DRUM_TRIGGER_CHANNELS) - 1);
+    drumDma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(drumDma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    dma_channel_configure(drumDma, &c, drumBlocks[0], &adc_hw->fifo, DRUM_TRIGGER_BLOCK, false);
+    dma_channel_set_irq1_enabled(drumDma, true);
+    irq_add_shared_handler(DMA_IRQ_1, drum_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+    drum_adc_start();
+}
+#endif
 uint16_t adc(uint8_t pin) {
+#ifdef INPUT_DRUM_TRIGGER
+    // Piezo pads report the peak of their last hit while it is held, instead of whatever the pin happens to read now
+    if (DRUM_TRIGGER_MASK & (1 << pin)) {
+        return drumTriggerRead(pin);
+    }
+    return adcReading[pin];
+#else
     adc_select_input(pin);
     return adc_read() << 4;
+#endif
 }
 
 void initPins(void) {
     adc_init();
     PIN_INIT;
+#ifdef INPUT_DRUM_TRIGGER
+    drum_adc_init();
+#endif
 }
 
 uint8_t digital_read(uint8_t port, uint8_t mask) {
@@ -46,6 +130,15 @@ void digital_write(uint8_t port, uint8_t mask, uint8_t activeMask) {
     gpio_put_masked(mask32, activeMask32);
 }
 
+void pin_init_pullup(uint8_t pin) {
+    gpio_init(pin);
+    gpio_set_pulls(pin, true, false);
+}
+
+bool pin_read(uint8_t pin) {
+    return gpio_get(pin);
+}
+
 uint16_t adc_read(uint8_t pin, uint8_t mask) {
     bool detecting = pin & (1 << 7);
     if (detecting) {
@@ -54,11 +147,17 @@ uint16_t adc_read(uint8_t pin, uint8_t mask) {
         gpio_set_pulls(pin + PIN_A0, true, false);
         gpio_set_input_enabled(pin + PIN_A0, false);
     }
+#ifdef INPUT_DRUM_TRIGGER
+    drum_adc_stop();
+#endif
     adc_select_input(pin);
     uint16_t data = adc_read() << 4;
     if (detecting) {
         PIN_INIT;
     }
+#ifdef INPUT_DRUM_TRIGGER
+    drum_adc_start();
+#endif
     return data;
 }
 
@@ -67,9 +166,16 @@ uint16_t multiplexer_read(uint8_t pin, uint32_t mask, uint32_t bits) {
         gpio_put_masked(mask, bits);
 #ifdef CD4051BE
         sleep_us(50);
+#endif
+#ifdef INPUT_DRUM_TRIGGER
+        drum_adc_stop();
 #endif
         adc_select_input(pin);
-        return adc_read() << 4;
+        uint16_t data = adc_read() << 4;
+#ifdef INPUT_DRUM_TRIGGER
+        drum_adc_start();
+#endif
+        return data;
     }
     return 0;
 }
\ No newline at end of file
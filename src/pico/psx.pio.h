@@ -0,0 +1,72 @@
+// -------------------------------------------------- //
+// This file is autogenerated by pioasm; do not edit! //
+// -------------------------------------------------- //
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// --- //
+// psx //
+// --- //
+
+#define psx_wrap_target 0
+#define psx_wrap 11
+
+static const uint16_t psx_program_instructions[] = {
+            //     .wrap_target
+    0x98a0, //  0: pull   block           side 1
+    0xe027, //  1: set    x, 7
+    0x7701, //  2: out    pins, 1         side 0 [7]
+    0x5b01, //  3: in     pins, 1         side 1 [3]
+    0x0342, //  4: jmp    x--, 2                 [3]
+    0x8020, //  5: push   block
+    0xe022, //  6: set    x, 2
+    0xe05f, //  7: set    y, 31
+    0x00ca, //  8: jmp    pin, 10
+    0x0000, //  9: jmp    0
+    0x0088, // 10: jmp    y--, 8
+    0x0047, // 11: jmp    x--, 7
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program psx_program = {
+    .instructions = psx_program_instructions,
+    .length = 12,
+    .origin = -1,
+};
+
+static inline pio_sm_config psx_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + psx_wrap_target, offset + psx_wrap);
+    sm_config_set_sideset(&c, 2, true, false);
+    return c;
+}
+
+#include "hardware/clocks.h"
+static inline void psx_program_init(PIO pio, uint sm, uint offset, uint cmd, uint dat, uint clk, uint ack) {
+    pio_sm_config c = psx_program_get_default_config(offset);
+    sm_config_set_out_pins(&c, cmd, 1);
+    sm_config_set_in_pins(&c, dat);
+    sm_config_set_sideset_pins(&c, clk);
+    sm_config_set_jmp_pin(&c, ack);
+    // Data is LSB first in both directions
+    sm_config_set_out_shift(&c, true, false, 8);
+    sm_config_set_in_shift(&c, true, false, 8);
+    sm_config_set_clkdiv(&c, (float)clock_get_hz(clk_sys) / 4000000);
+    pio_sm_set_pins_with_mask(pio, sm, (1u << cmd) | (1u << clk), (1u << cmd) | (1u << clk));
+    pio_sm_set_pindirs_with_mask(pio, sm, (1u << cmd) | (1u << clk), (1u << cmd) | (1u << clk) | (1u << dat) | (1u << ack));
+    pio_gpio_init(pio, cmd);
+    pio_gpio_init(pio, clk);
+    pio_gpio_init(pio, dat);
+    // DAT and ACK are open collector on the controller side
+    gpio_pull_up(dat);
+    gpio_pull_up(ack);
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+#endif
@@ -0,0 +1,72 @@
+#include "usb_host_devices.h"
+
+#include <string.h>
+
+#include "log.h"
+#if USB_HOST_STACK
+uint8_t total_usb_host_devices = 0;
+Usb_Host_Device_t usb_host_devices[USB_HOST_DEVICE_MAX];
+uint8_t usb_host_slots[CFG_TUH_DEVICE_MAX][CFG_TUH_XINPUT];
+uint64_t usb_host_devices_by_type[USB_HOST_CONSOLE_TYPES];
+
+Usb_Host_Device_t *find_usb_host_device(uint8_t dev_addr, uint8_t instance) {
+    if (!dev_addr || dev_addr > CFG_TUH_DEVICE_MAX || instance >= CFG_TUH_XINPUT) {
+        return NULL;
+    }
+    uint8_t slot = usb_host_slots[dev_addr - 1][instance];
+    if (!slot) {
+        return NULL;
+    }
+    return &usb_host_devices[slot - 1];
+}
+
+void add_usb_host_device(USB_Device_Type_t type, uint8_t identify) {
+    if (!type.dev_addr || type.dev_addr > CFG_TUH_DEVICE_MAX || type.instance >= CFG_TUH_XINPUT) {
+        LOG_ERROR("Invalid device %d, %d", type.dev_addr, type.instance);
+        return;
+    }
+    // Reuse the lowest free slot, so devices that stay plugged in keep their slot
+    uint8_t slot = 0;
+    while (slot < USB_HOST_DEVICE_MAX && usb_host_devices[slot].used) {
+        slot++;
+    }
+    if (slot == USB_HOST_DEVICE_MAX) {
+        LOG_ERROR("No room for device %d, %d", type.dev_addr, type.instance);
+        return;
+    }
+    Usb_Host_Device_t *device = &usb_host_devices[slot];
+    uint8_t generation = device->generation + 1;
+    memset(device, 0, sizeof(Usb_Host_Device_t));
+    device->type = type;
+    device->used = true;
+    device->changed = true;
+    device->generation = generation;
+    device->identify = identify;
+    usb_host_slots[type.dev_addr - 1][type.instance] = slot + 1;
+    if (!identify && type.console_type < USB_HOST_CONSOLE_TYPES) {
+        usb_host_devices_by_type[type.console_type] |= 1ULL << slot;
+    }
+    if (slot >= total_usb_host_devices) {
+        total_usb_host_devices = slot + 1;
+    }
+}
+
+void remove_usb_host_device(uint8_t dev_addr, uint8_t instance) {
+    Usb_Host_Device_t *device = find_usb_host_device(dev_addr, instance);
+    if (!device) {
+        return;
+    }
+    uint8_t slot = device - usb_host_devices;
+    usb_host_slots[dev_addr - 1][instance] = 0;
+    if (device->type.console_type < USB_HOST_CONSOLE_TYPES) {
+        usb_host_devices_by_type[device->type.console_type] &= ~(1ULL << slot);
+    }
+    // Other devices keep their slots, the slot just reads as empty until it is reused
+    device->used = false;
+    device->type = {NON_CONTROLLER, 0, 0, 0};
+    device->report_length = 0;
+    while (total_usb_host_devices && !usb_host_devices[total_usb_host_devices - 1].used) {
+        total_usb_host_devices--;
+    }
+}
+#endif
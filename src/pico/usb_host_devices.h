@@ -0,0 +1,54 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+#include "config.h"
+#include "shared_main.h"
+#include "tusb_config.h"
+#if USB_HOST_STACK
+// Every controller plugged into the USB host port, one slot per (dev_addr, instance)
+#define USB_HOST_DEVICE_MAX (CFG_TUH_DEVICE_MAX * CFG_TUH_XINPUT)
+#define USB_HOST_CONSOLE_TYPES (LTEK_ID + 1)
+typedef struct {
+    USB_Device_Type_t type;
+    USB_LastReport_Data_t report;
+    uint8_t report_length;
+    bool switch_sent_timeout;
+    bool switch_sent_handshake;
+    uint8_t xone_init_id;
+    bool used;
+    // Devices that need more requests to work out what they are stay hidden until that is done
+    uint8_t identify;
+    bool identify_waiting;
+    uint8_t identify_attempts;
+    uint8_t identify_product;
+    uint32_t identify_at;
+    // Set when a report arrives, so the input merge knows to decode this device again
+    bool changed;
+    USB_Host_Data_t decoded;
+    // Bumped every time the slot is reused, so state kept for a slot can tell that the device changed
+    uint8_t generation;
+} Usb_Host_Device_t;
+enum {
+    USB_HOST_IDENTIFY_NONE,
+    // Santroller sub types are in bcdDevice, and PS3 guitars need iProduct for the product string
+    USB_HOST_IDENTIFY_DEVICE,
+    // GHWT and GH5 guitars have the same vid and pid, but different tap bar functions. The product name tells them apart
+    USB_HOST_IDENTIFY_PRODUCT,
+    // Raphnet adapters report what is plugged into them through a feature report, which takes a few tries after plugging in
+    USB_HOST_IDENTIFY_RAPHNET
+};
+// One past the highest slot in use, slots below this may be free
+extern uint8_t total_usb_host_devices;
+extern Usb_Host_Device_t usb_host_devices[USB_HOST_DEVICE_MAX];
+// Maps (dev_addr, instance) to an index + 1 into usb_host_devices (0 if nothing is there), so report callbacks don't need to search for their device
+extern uint8_t usb_host_slots[CFG_TUH_DEVICE_MAX][CFG_TUH_XINPUT];
+// Bitmask of usb_host_devices indexes for each console type
+extern uint64_t usb_host_devices_by_type[USB_HOST_CONSOLE_TYPES];
+
+Usb_Host_Device_t *find_usb_host_device(uint8_t dev_addr, uint8_t instance);
+// Takes the lowest free slot for a newly mounted device. The slot is reset, and its generation bumped
+void add_usb_host_device(USB_Device_Type_t type, uint8_t identify = USB_HOST_IDENTIFY_NONE);
+// Frees only this device's slot, everything else keeps the slot it has
+void remove_usb_host_device(uint8_t dev_addr, uint8_t instance);
+#endif
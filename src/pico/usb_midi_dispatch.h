@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+
+// Decodes received USB MIDI packets straight into handlers. USB MIDI packets are already framed,
+// so the code index number says what the message is. Any handler can be left null, and that
+// message is then ignored. This has no dependencies on TinyUSB or the MIDI library, so it can be
+// tested on the host.
+#define USB_MIDI_PITCHBEND_MIN -8192
+struct UsbMidiHandlers {
+    void (*handleNoteOn)(uint8_t channel, uint8_t note, uint8_t velocity) = nullptr;
+    void (*handleNoteOff)(uint8_t channel, uint8_t note, uint8_t velocity) = nullptr;
+    void (*handleControlChange)(uint8_t channel, uint8_t number, uint8_t value) = nullptr;
+    void (*handlePitchBend)(uint8_t channel, int bend) = nullptr;
+
+    bool hasHandlers() const {
+        return handleNoteOn || handleNoteOff || handleControlChange || handlePitchBend;
+    }
+
+    void dispatch(uint8_t cableNumber, const uint8_t bytes[4]) const {
+        if ((bytes[0] >> 4) != cableNumber) return;
+        uint8_t channel = (bytes[1] & 0x0F) + 1;
+        switch (bytes[0] & 0x0F) {
+            case 0x8:
+                if (handleNoteOff) {
+                    handleNoteOff(channel, bytes[2], bytes[3]);
+                }
+                break;
+            case 0x9:
+                // A note on with no velocity is a note off
+                if (bytes[3]) {
+                    if (handleNoteOn) {
+                        handleNoteOn(channel, bytes[2], bytes[3]);
+                    }
+                } else if (handleNoteOff) {
+                    handleNoteOff(channel, bytes[2], bytes[3]);
+                }
+                break;
+            case 0xB:
+                if (handleControlChange) {
+                    handleControlChange(channel, bytes[2], bytes[3]);
+                }
+                break;
+            case 0xE:
+                if (handlePitchBend) {
+                    handlePitchBend(channel, ((bytes[3] << 7) | bytes[2]) + USB_MIDI_PITCHBEND_MIN);
+                }
+                break;
+        }
+    }
+};
@@ -0,0 +1,57 @@
+// -------------------------------------------------- //
+// This file is autogenerated by pioasm; do not edit! //
+// -------------------------------------------------- //
+
+#pragma once
+
+#if !PICO_NO_HARDWARE
+#include "hardware/pio.h"
+#endif
+
+// -- //
+// wt //
+// -- //
+
+#define wt_wrap_target 0
+#define wt_wrap 9
+
+static const uint16_t wt_program_instructions[] = {
+            //     .wrap_target
+    0x80a0, //  0: pull   block
+    0xa027, //  1: mov    x, osr
+    0xe001, //  2: set    pins, 1
+    0xff81, //  3: set    pindirs, 1             [31]
+    0xe080, //  4: set    pindirs, 0
+    0x00c7, //  5: jmp    pin, 7
+    0x0008, //  6: jmp    8
+    0x0045, //  7: jmp    x--, 5
+    0x4020, //  8: in     x, 32
+    0x8020, //  9: push   block
+            //     .wrap
+};
+
+#if !PICO_NO_HARDWARE
+static const struct pio_program wt_program = {
+    .instructions = wt_program_instructions,
+    .length = 10,
+    .origin = -1,
+};
+
+static inline pio_sm_config wt_program_get_default_config(uint offset) {
+    pio_sm_config c = pio_get_default_sm_config();
+    sm_config_set_wrap(&c, offset + wt_wrap_target, offset + wt_wrap);
+    return c;
+}
+
+static inline void wt_program_init(PIO pio, uint sm, uint offset, uint pin) {
+    pio_sm_config c = wt_program_get_default_config(offset);
+    sm_config_set_set_pins(&c, pin, 1);
+    sm_config_set_jmp_pin(&c, pin);
+    pio_gpio_init(pio, pin);
+    gpio_set_pulls(pin, false, false);
+    pio_sm_set_consecutive_pindirs(pio, sm, pin, 1, false);
+    pio_sm_init(pio, sm, offset, &c);
+    pio_sm_set_enabled(pio, sm, true);
+}
+
+#endif
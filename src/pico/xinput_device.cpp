@@ -22,13 +22,13 @@ typedef struct {
     uint8_t ep_out;         // optional Out endpoint
     uint8_t boot_protocol;  // Boot mouse or keyboard
     bool boot_mode;         // default = false (Report)
+    bool sending;
 
     CFG_TUSB_MEM_ALIGN uint8_t epin_buf[CFG_TUD_XINPUT_TX_BUFSIZE];
     CFG_TUSB_MEM_ALIGN uint8_t epout_buf[CFG_TUD_XINPUT_RX_BUFSIZE];
 } xinputd_interface_t;
 
 CFG_TUSB_MEM_SECTION static xinputd_interface_t _xinputd_itf[CFG_TUD_XINPUT];
-static volatile bool sending = false;
 /*------------- Helpers -------------*/
 static inline uint8_t get_index_by_itfnum(uint8_t itf_num) {
     for (uint8_t i = 0; i < CFG_TUD_XINPUT; i++) {
@@ -47,7 +47,11 @@ bool tud_xinput_n_ready(uint8_t itf) {
 }
 
 bool tud_ready_for_packet(void) {
-    return !sending;
+    return !_xinputd_itf[0].sending;
+}
+
+uint8_t tud_xinput_index(uint8_t itf_num) {
+    return get_index_by_itfnum(itf_num);
 }
 
 bool tud_xusb_n_report(uint8_t itf, void const *report, uint8_t len) {
@@ -58,7 +62,7 @@ bool tud_xusb_n_report(uint8_t itf, void const *report, uint8_t len) {
     TU_VERIFY(usbd_edpt_claim(rhport, p_xinput->ep_in));
 
     memcpy(p_xinput->epin_buf, report, len);
-    sending = true;
+    p_xinput->sending = true;
     return usbd_edpt_xfer(TUD_OPT_RHPORT, p_xinput->ep_in, p_xinput->epin_buf, len);
 }
 
@@ -82,7 +86,7 @@ bool tud_xinput_n_report(uint8_t itf, uint8_t report_id, void const *report,
         len = tu_min8(len, CFG_TUD_XINPUT_TX_BUFSIZE);
         memcpy(p_xinput->epin_buf, report, len);
     }
-    sending = true;
+    p_xinput->sending = true;
     return usbd_edpt_xfer(TUD_OPT_RHPORT, p_xinput->ep_in, p_xinput->epin_buf,
                           len);
 }
@@ -99,7 +103,6 @@ void xinputd_init(void) {
 void xinputd_reset(uint8_t rhport) {
     (void)rhport;
     tu_memclr(_xinputd_itf, sizeof(_xinputd_itf));
-    sending = false;
 }
 
 uint16_t xinputd_open(uint8_t rhport, tusb_desc_interface_t const *itf_desc,
@@ -260,7 +263,13 @@ bool xinputd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result,
         if (ep_addr == p_xinput->ep_out || ep_addr == p_xinput->ep_in) break;
     }
     if (ep_addr == p_xinput->ep_out) {
-        hid_set_report(p_xinput->epout_buf, xferred_bytes, 0x00, INTERRUPT_ID);
+#if USB_HOST_PASSTHROUGH
+        // Rumble and leds for a passthrough interface go to the controller behind it, not to us
+        if (consoleType == WINDOWS && p_xinput->itf_num >= INTERFACE_ID_Passthrough) {
+            handle_usb_host_passthrough_output(p_xinput->itf_num - INTERFACE_ID_Passthrough, p_xinput->epout_buf, xferred_bytes);
+        } else
+#endif
+            hid_set_report(p_xinput->epout_buf, xferred_bytes, 0x00, INTERRUPT_ID);
         if (consoleType == XBOX360 || consoleType == WINDOWS || consoleType == OG_XBOX) {
             TU_ASSERT(usbd_edpt_xfer(rhport, p_xinput->ep_out, p_xinput->epout_buf,
                                      0x20));
@@ -276,7 +285,7 @@ bool xinputd_xfer_cb(uint8_t rhport, uint8_t ep_addr, xfer_result_t result,
         }
 
     } else if (ep_addr == p_xinput->ep_in) {
-        sending = false;
+        p_xinput->sending = false;
     }
     return true;
 }
@@ -44,6 +44,9 @@ bool tud_xinput_n_ready(uint8_t itf);
 
 bool tud_ready_for_packet(void);
 
+// Index of the interface with the given interface number, or 0xFF if it was never opened
+uint8_t tud_xinput_index(uint8_t itf_num);
+
 // Check if current mode is Boot (true) or Report (false)
 bool tud_xinput_n_boot_mode(uint8_t itf);
 
@@ -30,10 +30,12 @@
 #include "class/hid/hid.h"
 #include "defines.h"
 #include "descriptors.h"
+#include "generic_hid.h"
 #include "hid.h"
 #include "hidparser.h"
 #include "host/usbh.h"
 #include "host/usbh_classdriver.h"
+#include "log.h"
 #include "xinput_host.h"
 
 #define INVALID_REPORT_ID -1
@@ -54,9 +56,13 @@ typedef struct
 
     uint8_t epin_buf[CFG_TUH_XINPUT_EPIN_BUFSIZE];
     uint8_t epout_buf[CFG_TUH_XINPUT_EPOUT_BUFSIZE];
-    HID_ReportInfo_t *info;
+    struct generic_plan_s *plan;
+    uint8_t hid_status;
 } xinputh_interface_t;
 
+// Parsing only happens during enumeration, one interface at a time, so all devices share the one arena
+static HID_Parser_Arena_t parser_arena;
+
 typedef struct
 {
     uint8_t inst_count;
@@ -82,6 +88,10 @@ uint8_t tuh_xinput_instance_count(uint8_t dev_addr) {
     return get_dev(dev_addr)->inst_count;
 }
 
+uint8_t tuh_xinput_hid_status(uint8_t dev_addr, uint8_t instance) {
+    return get_instance(dev_addr, instance)->hid_status;
+}
+
 bool tuh_xinput_mounted(uint8_t dev_addr, uint8_t instance) {
     if (get_dev(dev_addr)->inst_count < instance) return false;
     xinputh_interface_t *hid_itf = get_instance(dev_addr, instance);
@@ -132,90 +142,8 @@ void xinputh_init(void) {
     tu_memclr(_xinputh_dev, sizeof(_xinputh_dev));
 }
 
-static inline bool USB_GetHIDReportItemInfoWithReportId(const uint8_t *ReportData, HID_ReportItem_t *const ReportItem) {
-    if (ReportItem->ReportID) {
-        if (ReportItem->ReportID != ReportData[0])
-            return false;
-
-        ReportData++;
-    }
-    return USB_GetHIDReportItemInfo(ReportItem->ReportID, ReportData, ReportItem);
-}
-
-uint16_t GetAxis(HID_ReportItem_t *item) {
-    uint8_t size = item->Attributes.BitSize;
-    uint32_t val = item->Value;
-    if (size > 16) {
-        val >>= size - 16;
-    } else if (size < 16) {
-        val <<= 16 - size;
-    }
-    return val;
-}
-
 void fill_generic_report(uint8_t dev_addr, uint8_t instance, const uint8_t *report, USB_Host_Data_t *out) {
-    memset(out, 0, sizeof(USB_Host_Data_t));
-    xinputh_interface_t *hid_itf = get_instance(dev_addr, instance);
-    if (hid_itf->info != NULL) {
-        HID_ReportItem_t *item = hid_itf->info->FirstReportItem;
-        while (item) {
-            if (USB_GetHIDReportItemInfoWithReportId(report, item)) {
-                switch (item->Attributes.Usage.Page) {
-                    case HID_USAGE_PAGE_DESKTOP:
-                        switch (item->Attributes.Usage.Usage) {
-                            case HID_USAGE_DESKTOP_X:
-                                out->genericAxisX = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_Y:
-                                out->genericAxisY = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_Z:
-                                out->genericAxisZ = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_RX:
-                                out->genericAxisRx = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_RY:
-                                out->genericAxisRy = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_RZ:
-                                out->genericAxisRz = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_SLIDER:
-                                out->genericAxisSlider = GetAxis(item);
-                                break;
-                            case HID_USAGE_DESKTOP_HAT_SWITCH:
-                                out->dpadLeft = item->Value == 6 || item->Value == 5 || item->Value == 7;
-                                out->dpadRight = item->Value == 3 || item->Value == 2 || item->Value == 1;
-                                out->dpadUp = item->Value == 0 || item->Value == 1 || item->Value == 7;
-                                out->dpadDown = item->Value == 5 || item->Value == 4 || item->Value == 3;
-                                break;
-                            case HID_USAGE_DESKTOP_DPAD_UP:
-                                out->dpadUp = 1;
-                                break;
-                            case HID_USAGE_DESKTOP_DPAD_RIGHT:
-                                out->dpadRight = 1;
-                                break;
-                            case HID_USAGE_DESKTOP_DPAD_DOWN:
-                                out->dpadDown = 1;
-                                break;
-                            case HID_USAGE_DESKTOP_DPAD_LEFT:
-                                out->dpadLeft = 1;
-                                break;
-                        }
-                        break;
-                    case HID_USAGE_PAGE_BUTTON: {
-                        uint8_t usage = item->Attributes.Usage.Usage;
-                        if (usage <= 16 && item->Value) {
-                            out->genericButtons |= 1 << usage - 1;
-                        }
-                        break;
-                    }
-                }
-            }
-            item = item->Next;
-        }
-    }
+    decode_generic_report(get_instance(dev_addr, instance)->plan, report, out);
 }
 bool xinputh_xfer_cb(uint8_t dev_addr, uint8_t ep_addr, xfer_result_t result, uint32_t xferred_bytes) {
     (void)result;
@@ -242,8 +170,8 @@ void xinputh_close(uint8_t dev_addr) {
         if (tuh_xinput_umount_cb) {
             tuh_xinput_umount_cb(dev_addr, inst);
         }
-        if (hid_dev->instances[inst].info != NULL) {
-            USB_FreeReportInfo(hid_dev->instances[inst].info);
+        if (hid_dev->instances[inst].plan != NULL) {
+            hid_dev->instances[inst].plan->used = false;
         }
     }
 
@@ -263,28 +191,7 @@ bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t *const CurrentItem)
         }
     }
 
-    if (CurrentItem->ItemType != HID_REPORT_ITEM_In)
-        return false;
-
-    switch (CurrentItem->Attributes.Usage.Page) {
-        case HID_USAGE_PAGE_DESKTOP:
-            switch (CurrentItem->Attributes.Usage.Usage) {
-                case HID_USAGE_DESKTOP_X:
-                case HID_USAGE_DESKTOP_Y:
-                case HID_USAGE_DESKTOP_Z:
-                case HID_USAGE_DESKTOP_RZ:
-                case HID_USAGE_DESKTOP_HAT_SWITCH:
-                case HID_USAGE_DESKTOP_DPAD_UP:
-                case HID_USAGE_DESKTOP_DPAD_DOWN:
-                case HID_USAGE_DESKTOP_DPAD_LEFT:
-                case HID_USAGE_DESKTOP_DPAD_RIGHT:
-                    return true;
-            }
-            return false;
-        case HID_USAGE_PAGE_BUTTON:
-            return true;
-    }
-    return false;
+    return generic_hid_wants_item(CurrentItem);
 }
 
 //--------------------------------------------------------------------+
@@ -368,7 +275,8 @@ bool xinputh_open(uint8_t rhport, uint8_t dev_addr, tusb_desc_interface_t const
             foundPS3 = false;
             foundPS4 = false;
             foundPS5 = false;
-            USB_ProcessHIDReport(temp_buf, x_desc->wDescriptorLength, &p_xinput->info);
+            HID_ReportInfo_t *info = NULL;
+            p_xinput->hid_status = USB_ProcessHIDReport(&parser_arena, temp_buf, x_desc->wDescriptorLength, &info);
             if (foundPS5) {
                 p_xinput->type = PS5;
             }
@@ -378,6 +286,17 @@ bool xinputh_open(uint8_t rhport, uint8_t dev_addr, tusb_desc_interface_t const
             if (foundPS3) {
                 p_xinput->type = PS3;
             }
+            // PS3/4/5 controllers have their own report decoding, so only generic devices use up a plan.
+            // Only the compiled plan is needed after this, so the arena is free for the next device
+            if (p_xinput->type == GENERIC && p_xinput->hid_status == HID_PARSE_Successful) {
+                p_xinput->plan = compile_generic_plan(info);
+                if (p_xinput->plan == NULL) {
+                    p_xinput->hid_status = XINPUTH_HID_NO_PLAN;
+                }
+            }
+            if (p_xinput->type == GENERIC && p_xinput->hid_status != HID_PARSE_Successful) {
+                LOG_ERROR("HID descriptor on %d, %d not usable: %d", dev_addr, i, p_xinput->hid_status);
+            }
         }
         _xinputh_dev->inst_count++;
         tuh_xinput_receive_report(dev_addr, i);
@@ -69,6 +69,11 @@ uint8_t tuh_xinput_instance_count(uint8_t dev_addr);
 // Check if XINPUT instance is mounted
 bool tuh_xinput_mounted(uint8_t dev_addr, uint8_t instance);
 
+// Result of parsing the HID report descriptor for generic HID instances, HID_PARSE_Successful (0) if it is usable
+uint8_t tuh_xinput_hid_status(uint8_t dev_addr, uint8_t instance);
+// The descriptor parsed, but there was no room for its extraction plan or nothing in it we can use
+#define XINPUTH_HID_NO_PLAN 0x80
+
 // Get interface supported protocol (bInterfaceProtocol) check out XINPUT_interface_protocol_enum_t for possible values
 uint8_t tuh_xinput_interface_protocol(uint8_t dev_addr, uint8_t instance);
 
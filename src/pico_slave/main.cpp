@@ -2,9 +2,11 @@
 #include <SPI.h>
 #include <Wire.h>
 #include <hardware/adc.h>
+#include <hardware/dma.h>
 
 #include "io.h"
 #include "pico_slave.h"
+#include "wt.h"
 #ifdef TWI_1_SDA
 #define WIRE Wire1
 #else
@@ -19,8 +21,18 @@ volatile uint8_t wtS2Pin = 0;
 volatile uint16_t wt_sensitivity = 0;
 volatile uint8_t rawWt;
 volatile uint32_t lastWt[5] = {0};
+Wt_Baseline_t wtBaselines[5] = {0};
 volatile bool hasInitWt = false;
+volatile uint8_t analogMask = 0;
+volatile uint8_t interruptPin = INVALID_PIN;
 spi_inst_t* hardware;
+// LED frames are streamed out over DMA, alternating buffers so the next frame can be received while the last one is sent
+int spiDma = -1;
+uint8_t spiFrames[2][SLAVE_SPI_FRAME_MAX];
+uint8_t spiFrame = 0;
+// Snapshots are double buffered, so a read from the main controller never sees a half written one
+Slave_Snapshot_t snapshots[2];
+volatile uint8_t currentSnapshot = 0;
 void recv(int len) {
     command = WIRE.read();
     switch (command) {
@@ -53,6 +65,9 @@ void recv(int len) {
                     break;
                 case PIN_MODE_ANALOG:
                     adc_gpio_init(pin);
+                    if (pin >= PIN_A0 && pin < PIN_A0 + SLAVE_ANALOG_COUNT) {
+                        analogMask |= 1 << (pin - PIN_A0);
+                    }
                     break;
                 case PIN_MODE_SPI:
                     gpio_set_function(pin, GPIO_FUNC_SPI);
@@ -92,12 +107,49 @@ void recv(int len) {
             }
             spi_init(hardware, F_CPU / 2);
             spi_set_format(hardware, 8, SPI_CPOL_1, SPI_CPHA_1, SPI_MSB_FIRST);
+            if (spiDma < 0) {
+                spiDma = dma_claim_unused_channel(true);
+            }
+            {
+                dma_channel_config c = dma_channel_get_default_config(spiDma);
+                channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+                channel_config_set_read_increment(&c, true);
+                channel_config_set_write_increment(&c, false);
+                channel_config_set_dreq(&c, spi_get_dreq(hardware, true));
+                dma_channel_configure(spiDma, &c, &spi_get_hw(hardware)->dr, spiFrames[0], 0, false);
+            }
             break;
         case SLAVE_COMMAND_WRITE_SPI: {
             uint8_t data = WIRE.read();
+            if (spiDma < 0) {
+                break;
+            }
+            dma_channel_wait_for_finish_blocking(spiDma);
             spi_write_blocking(hardware, &data, 1);
             break;
         }
+        case SLAVE_COMMAND_WRITE_SPI_FRAME: {
+            uint8_t* frame = spiFrames[spiFrame];
+            uint8_t frameLen = 0;
+            while (WIRE.available() && frameLen < SLAVE_SPI_FRAME_MAX) {
+                frame[frameLen++] = WIRE.read();
+            }
+            if (!frameLen || spiDma < 0) {
+                break;
+            }
+            // Only wait if the previous frame is still going out
+            dma_channel_wait_for_finish_blocking(spiDma);
+            dma_channel_transfer_from_buffer_now(spiDma, frame, frameLen);
+            spiFrame = !spiFrame;
+            break;
+        }
+        case SLAVE_COMMAND_INIT_INTERRUPT:
+            interruptPin = WIRE.read();
+            // The line is open drain, so it is released by switching it to an input
+            gpio_init(interruptPin);
+            gpio_put(interruptPin, 0);
+            gpio_set_dir(interruptPin, false);
+            break;
         case SLAVE_COMMAND_INIT_WT:
             wtInputPin = WIRE.read();
             wtS0Pin = WIRE.read();
@@ -129,6 +181,25 @@ void req() {
             }
             break;
         }
+        case SLAVE_COMMAND_GET_WT_TRACKING: {
+            // The tracked baseline for each pad followed by its noise, clamped to fit a single transaction
+            uint16_t tracked[SLAVE_WT_COUNT * 2];
+            for (int i = 0; i < SLAVE_WT_COUNT; i++) {
+                uint32_t baseline = wtBaseline(&wtBaselines[i]);
+                uint32_t noise = wtNoise(&wtBaselines[i]);
+                tracked[i] = baseline > UINT16_MAX ? UINT16_MAX : baseline;
+                tracked[i + SLAVE_WT_COUNT] = noise > UINT16_MAX ? UINT16_MAX : noise;
+            }
+            WIRE.write((uint8_t*)tracked, sizeof(tracked));
+            break;
+        }
+        case SLAVE_COMMAND_GET_SNAPSHOT: {
+            WIRE.write((uint8_t*)&snapshots[currentSnapshot], sizeof(Slave_Snapshot_t));
+            if (interruptPin != INVALID_PIN) {
+                gpio_set_dir(interruptPin, false);
+            }
+            break;
+        }
         case SLAVE_COMMAND_INITIALISE: {
             uint8_t ret = SLAVE_COMMAND_INITIALISE;
             WIRE.write(&ret, sizeof(ret));
@@ -140,21 +211,20 @@ void req() {
 uint32_t lastWtSum[5] = {0};
 uint32_t lastWtAvg[5][WT_BUFFER] = {0};
 uint8_t nextWt[5] = {0};
-uint32_t initialWt[5] = {0};
 uint32_t readWtSlave(int pin) {
     gpio_put_masked(mask, ((pin & (1 << 0)) << wtS0Pin - 0) | ((pin & (1 << 1)) << (wtS1Pin - 1)) | ((pin & (1 << 2)) << (wtS2Pin - 2)));
-    uint32_t m = rp2040.getCycleCount();
     gpio_put(wtInputPin, 1);
     gpio_set_dir(wtInputPin, true);
     sleep_us(10);
+    uint32_t m = rp2040.getCycleCount();
     gpio_set_dir(wtInputPin, false);
     gpio_set_pulls(wtInputPin, false, false);
     while (gpio_get(wtInputPin)) {
-        m++;
-        if (m > 10000) {
+        if (rp2040.getCycleCount() - m > 10000) {
             break;
         }
     }
+    m = rp2040.getCycleCount() - m;
     if (pin >= 6) {
         return m;
     }
@@ -170,29 +240,67 @@ uint32_t readWtSlave(int pin) {
     return m;
 }
 bool checkWtSlave(int pin) {
-    return readWtSlave(pin) > initialWt[pin];
+    if (pin >= 6) {
+        readWtSlave(pin);
+        return false;
+    }
+    return wtUpdate(&wtBaselines[pin], readWtSlave(pin), wt_sensitivity, millis());
+}
+
+void updateSnapshot() {
+    uint8_t next = !currentSnapshot;
+    Slave_Snapshot_t* snapshot = &snapshots[next];
+    snapshot->header = SLAVE_COMMAND_GET_SNAPSHOT;
+    snapshot->digital = sio_hw->gpio_in;
+    if (interruptPin != INVALID_PIN) {
+        // Don't let the interrupt line trigger itself
+        snapshot->digital &= ~(1 << interruptPin);
+    }
+    snapshot->wt = rawWt;
+    for (int i = 0; i < SLAVE_WT_COUNT; i++) {
+        snapshot->wtRaw[i] = lastWt[i] > UINT16_MAX ? UINT16_MAX : lastWt[i];
+    }
+    for (int i = 0; i < SLAVE_ANALOG_COUNT; i++) {
+        if (analogMask & (1 << i)) {
+            adc_select_input(i);
+            snapshot->analog[i] = adc_read() << 4;
+        } else {
+            snapshot->analog[i] = 0;
+        }
+    }
+    // Only publish a new sequence number when something actually changed
+    Slave_Snapshot_t* current = &snapshots[currentSnapshot];
+    snapshot->sequence = current->sequence;
+    snapshot->checksum = current->checksum;
+    if (memcmp(snapshot, current, sizeof(Slave_Snapshot_t)) == 0) {
+        return;
+    }
+    snapshot->sequence = current->sequence + 1;
+    snapshot->checksum = slaveSnapshotChecksum(snapshot);
+    // Analog values and raw WT counts are noisy, so only digital and WT changes are signalled to the main controller
+    bool signal = snapshot->digital != current->digital || snapshot->wt != current->wt;
+    currentSnapshot = next;
+    if (signal && interruptPin != INVALID_PIN) {
+        gpio_set_dir(interruptPin, true);
+    }
 }
 
 void loop() {
     if (wtS2Pin && !hasInitWt) {
+        // The baselines are rebuilt in the background over the next few hundred sweeps
         hasInitWt = true;
-        memset(initialWt, 0, sizeof(initialWt));
-        for (int j = 0; j < 1000; j++) {
-            for (int i = 0; i < 5; i++) {
-                initialWt[i] += readWtSlave(i);
-            }
-        }
-        for (int i = 0; i < 5; i++) {
-            initialWt[i] /= 1000;
-            initialWt[i] += wt_sensitivity;
-        }
+        memset(wtBaselines, 0, sizeof(wtBaselines));
     }
     if (hasInitWt) {
         checkWtSlave(6);
         rawWt = checkWtSlave(1) | (checkWtSlave(0) << 1) | (checkWtSlave(2) << 2) | (checkWtSlave(3) << 3) | (checkWtSlave(4) << 4);
     }
+    updateSnapshot();
 }
 void setup() {
+    adc_init();
+    snapshots[0].header = SLAVE_COMMAND_GET_SNAPSHOT;
+    snapshots[0].checksum = slaveSnapshotChecksum(&snapshots[0]);
 #ifdef TWI_1_SDA
     WIRE.setSDA(TWI_1_SDA);
     WIRE.setSCL(TWI_1_SCL);
@@ -4,14 +4,17 @@
 #include <string.h>
 
 #include "Usb.h"
+#include "adxl.h"
 #include "bt.h"
 #include "commands.h"
 #include "config.h"
 #include "controllers.h"
 #include "io.h"
+#include "log.h"
 #include "keyboard_mouse.h"
 #include "pico_slave.h"
 #include "pin_funcs.h"
+#include "ps2.h"
 #include "ps3_wii_switch.h"
 #include "shared_main.h"
 #include "stdint.h"
@@ -60,184 +63,225 @@ bool strobing = false;
 long last_strobe = 0;
 PCStageKitOutput_Data_t stage_kit_report = {0};
 #ifdef INPUT_USB_HOST
+#include "tusb_config.h"
 
-uint8_t xone_sequences[8] = {1, 1, 1, 1, 1, 1, 1, 1};
-// Support up to 8 connected ps3 controllers (no idea why someone would do that but hey)
-ps4_output_report ps4_output_reports[8] = {
-    {
-        report_id : PS4_LED_RUMBLE_ID,
-        valid_flag0 : 0xFF,
-        valid_flag1 : 0x00,
-        reserved1 : 0x00,
-        motor_right : 0x00,
-        motor_left : 0x00,
-        lightbar_red : 0x00,
-        lightbar_green : 0x00,
-        lightbar_blue : 0x00,
-        lightbar_blink_on : 0,
-        lightbar_blink_off : 0,
-        reserved : {0}
-
-    }};
-ps3_output_report ps3_output_reports[8] = {
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
-    },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
-    },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
-    },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
+static const ps4_output_report ps4_output_template = {
+    report_id : PS4_LED_RUMBLE_ID,
+    valid_flag0 : 0xFF,
+    valid_flag1 : 0x00,
+    reserved1 : 0x00,
+    motor_right : 0x00,
+    motor_left : 0x00,
+    lightbar_red : 0x00,
+    lightbar_green : 0x00,
+    lightbar_blue : 0x00,
+    lightbar_blink_on : 0,
+    lightbar_blink_off : 0,
+    reserved : {0}};
+static const ps3_output_report ps3_output_template = {
+    report_id : PS3_LED_ID,
+    rumble : {
+        padding : 0x01,
+        right_duration : 0xFF,
+        right_motor_on : 0x00,
+        left_duration : 0xFF,
+        left_motor_force : 0x00,
     },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
+    padding : {0x00, 0x00, 0x00, 0x00},
+    leds_bitmap : 0x00,
+    led : {
+        {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
+        {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
+        {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
+        {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
     },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
-    },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x01,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
-    },
-    {
-        report_id : PS3_LED_ID,
-        rumble : {
-            padding : 0x00,
-            right_duration : 0xFF,
-            right_motor_on : 0x00,
-            left_duration : 0xFF,
-            left_motor_force : 0x00,
-        },
-        padding : {0x00, 0x00, 0x00, 0x00},
-        leds_bitmap : 0x00,
-        led : {
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-            {time_enabled : 0xFF, duty_length : 0x27, enabled : 0x10, duty_off : 0x00, duty_on : 0x32},
-        },
-        _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
-    }};
+    _reserved : {time_enabled : 0x00, duty_length : 0x00, enabled : 0x00, duty_off : 0x00, duty_on : 0x00},
+};
+// Only PS3, PS4 and Xbox One controllers keep output state around, and those always use a whole
+// device address, so one entry per address is enough no matter how many host slots are in use
+#define USB_HOST_OUTPUT_MAX CFG_TUH_DEVICE_MAX
+typedef struct {
+    bool used;
+    uint8_t slot;
+    uint8_t generation;
+    union {
+        ps3_output_report ps3;
+        ps4_output_report ps4;
+        uint8_t xone_sequence;
+    };
+} Usb_Host_Output_t;
+static Usb_Host_Output_t usb_host_outputs[USB_HOST_OUTPUT_MAX];
+
+// Returns the output state for a host slot, setting it up from the template for its console type
+// the first time it is needed. Entries left behind by unplugged devices are recycled.
+static Usb_Host_Output_t *get_usb_host_output(uint8_t id, uint8_t console_type) {
+    uint8_t generation = get_usb_host_device_generation(id);
+    Usb_Host_Output_t *output = NULL;
+    for (uint8_t i = 0; i < USB_HOST_OUTPUT_MAX; i++) {
+        Usb_Host_Output_t *entry = &usb_host_outputs[i];
+        if (entry->used && entry->slot == id && entry->generation == generation) {
+            return entry;
+        }
+        if (!output && (!entry->used || get_usb_host_device_generation(entry->slot) != entry->generation || get_usb_host_device_type(entry->slot).console_type == NON_CONTROLLER)) {
+            output = entry;
+        }
+    }
+    if (!output) {
+        LOG_ERROR("No output state left for host slot %d", id);
+        return NULL;
+    }
+    output->used = true;
+    output->slot = id;
+    output->generation = generation;
+    switch (console_type) {
+        case PS3:
+            output->ps3 = ps3_output_template;
+            break;
+        case PS4:
+            output->ps4 = ps4_output_template;
+            break;
+        case XBOXONE:
+            output->xone_sequence = 1;
+            break;
+    }
+    return output;
+}
 #endif
 
 void handle_auth_led(void) {
     authentication_successful();
     HANDLE_AUTH_LED;
 }
+#ifdef INPUT_USB_HOST
+static void send_xinput_w_player_led(uint8_t dev_addr, uint8_t instance, uint8_t player) {
+    uint8_t report[] = {0x00, 0x00, 0x08, (uint8_t)(0x40 | (player + LED_ONE - 1)), 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+    send_report_to_controller(dev_addr, instance, report, sizeof(report));
+}
+void handle_player_leds_xinput_w(uint8_t dev_addr, uint8_t instance) {
+    send_xinput_w_player_led(dev_addr, instance, current_player == 0xFF ? 1 : current_player);
+}
+// Returns true if nothing after this device should get the led
+static bool send_player_led_to_usb_host(uint8_t i, USB_Device_Type_t type, uint8_t player) {
+    switch (type.console_type) {
+        case PS3: {
+            // Only actual ds3s support this
+            Usb_Host_Output_t *output;
+            if (type.sub_type == GAMEPAD && (output = get_usb_host_output(i, PS3))) {
+                ps3_output_report *report = &output->ps3;
+                report->leds_bitmap |= _BV(player);
+                queue_transfer_with_usb_controller(type.dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0201, 0x00, sizeof(ps3_output_report), (uint8_t *)report);
+                // send_report_to_controller(type.dev_addr, (uint8_t *)report, sizeof(report));
+            }
+            return true;
+        }
+        case PS4: {
+            // Only actual ds4s support the lightbar
+            Usb_Host_Output_t *output;
+            if (type.sub_type == GAMEPAD && (output = get_usb_host_output(i, PS4))) {
+                ps4_output_report *report = &output->ps4;
+                report->lightbar_red = ps4_colors[player - 1][0];
+                report->lightbar_green = ps4_colors[player - 1][1];
+                report->lightbar_blue = ps4_colors[player - 1][2];
+                queue_transfer_with_usb_controller(type.dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0205, 0x00, sizeof(ps4_output_report), (uint8_t *)report);
+            }
+            return true;
+        }
+        case XBOX360: {
+            XInputLEDReport_t report = {
+                rid : XBOX_LED_ID,
+                rsize : sizeof(XInputLEDReport_t),
+                led : (uint8_t)(player + LED_ONE - 1)
+            };
+            send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)&report, sizeof(report));
+            return true;
+        }
+        case XBOX360_W: {
+            // Every linked controller on a receiver gets the led, not just the first one
+            if (type.sub_type != UNKNOWN) {
+                send_xinput_w_player_led(type.dev_addr, type.instance, player);
+            }
+            break;
+        }
+    }
+    return false;
+}
+#if DEVICE_TYPE == GAMEPAD || USB_HOST_PASSTHROUGH
+// Returns true if nothing after this device should rumble
+// Passthrough forwards whatever the host sent, so instruments get it too (e.g. stage kit commands)
+static bool send_rumble_to_usb_host(uint8_t i, USB_Device_Type_t type, uint8_t rumble_left, uint8_t rumble_right, bool passthrough) {
+    if (!passthrough && type.sub_type != GAMEPAD && type.sub_type != XINPUT_WHEEL) return false;
+    switch (type.console_type) {
+        case PS3: {
+            Usb_Host_Output_t *output = get_usb_host_output(i, PS3);
+            if (!output) return true;
+            ps3_output_report *report = &output->ps3;
+            report->rumble.left_motor_force = rumble_left;
+            report->rumble.right_motor_on = rumble_right != 0;
+            queue_transfer_with_usb_controller(type.dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0201, 0x00, sizeof(ps3_output_report), (uint8_t *)report);
+            return true;
+        }
+        case PS4: {
+            Usb_Host_Output_t *output = get_usb_host_output(i, PS4);
+            if (!output) return true;
+            ps4_output_report *report = &output->ps4;
+            report->motor_left = rumble_left;
+            report->motor_right = rumble_right != 0;
+            send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)report, sizeof(ps4_output_report));
+            return true;
+        }
+        case OG_XBOX: {
+            uint8_t rumble_packet[] = {0x00, 0x06, 0x00, rumble_left, 0x00, rumble_right};
+            send_report_to_controller(type.dev_addr, type.instance, rumble_packet, sizeof(rumble_packet));
+            return true;
+        }
+        case XBOX360: {
+            XInputRumbleReport_t report = {
+                rid : XBOX_RUMBLE_ID,
+                rsize : sizeof(XInputRumbleReport_t),
+                leftRumble : rumble_left,
+                rightRumble : rumble_right
+            };
+            send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)&report, sizeof(report));
+            return true;
+        }
+        case XBOX360_W: {
+            // Rumble every controller linked to a receiver, not just the first one
+            uint8_t rumble_packet[] = {0x00, 0x01, 0x0f, 0xc0, 0x00, rumble_left, rumble_right, 0x00, 0x00, 0x00, 0x00, 0x00};
+            send_report_to_controller(type.dev_addr, type.instance, rumble_packet, sizeof(rumble_packet));
+            return false;
+        }
+        case XBOXONE: {
+            Usb_Host_Output_t *output = get_usb_host_output(i, XBOXONE);
+            if (!output) return true;
+            GipRumble_t report;
+            GipRumble_t *packet = &report;
+            GIP_HEADER(packet, GIP_CMD_RUMBLE, true, output->xone_sequence++);
+            report.leftMotor = rumble_left;
+            report.rightMotor = rumble_right;
+            if (output->xone_sequence == 0) {
+                output->xone_sequence = 1;
+            }
+            send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)&report, sizeof(report));
+            return true;
+        }
+    }
+    return false;
+}
+#endif
+#if USB_HOST_PASSTHROUGH
+void handle_usb_host_passthrough_output(uint8_t id, const uint8_t *data, uint8_t len) {
+    USB_Device_Type_t type = get_usb_host_device_type(id);
+    if (len < 3 || type.console_type == NON_CONTROLLER) {
+        return;
+    }
+    if (data[0] == XBOX_LED_ID && data[2] < sizeof(xbox_players) && xbox_players[data[2]]) {
+        send_player_led_to_usb_host(id, type, xbox_players[data[2]]);
+    } else if (data[0] == XBOX_RUMBLE_ID && len >= 5) {
+        send_rumble_to_usb_host(id, type, data[3], data[4], true);
+    }
+}
+#endif
+#endif
 void handle_player_leds(uint8_t player) {
     if (player == current_player) return;
     if (player == 0) {
@@ -249,45 +293,9 @@ void handle_player_leds(uint8_t player) {
     current_player = player;
     HANDLE_PLAYER_LED;
 #ifdef INPUT_USB_HOST
-    USB_Device_Type_t type;
-    for (uint8_t i = 0; i < get_usb_host_device_count(); i++) {
-        type = get_usb_host_device_type(i);
-        switch (type.console_type) {
-            case PS3: {
-                // Only actual ds3s support this
-                if (type.sub_type == GAMEPAD) {
-                    ps3_output_report *report = &ps3_output_reports[i];
-                    report->leds_bitmap |= _BV(player);
-                    transfer_with_usb_controller(type.dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0201, 0x00, sizeof(ps3_output_report), (uint8_t *)report);
-                    // send_report_to_controller(type.dev_addr, (uint8_t *)report, sizeof(report));
-                }
-                return;
-            }
-            case PS4: {
-                // Only actual ds4s support the lightbar
-                if (type.sub_type == GAMEPAD) {
-                    ps4_output_report *report = &ps4_output_reports[i];
-                    report->lightbar_red = ps4_colors[player - 1][0];
-                    report->lightbar_green = ps4_colors[player - 1][1];
-                    report->lightbar_blue = ps4_colors[player - 1][2];
-                    transfer_with_usb_controller(type.dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0205, 0x00, sizeof(ps4_output_report), (uint8_t *)report);
-                }
-                return;
-            }
-            case XBOX360: {
-                XInputLEDReport_t report = {
-                    rid : XBOX_LED_ID,
-                    rsize : sizeof(XInputLEDReport_t),
-                    led : (uint8_t)(player + LED_ONE - 1)
-                };
-                send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)&report, sizeof(report));
-                return;
-            }
-            case XBOX360_W: {
-                uint8_t report[] = {0x00, 0x00, 0x08, (uint8_t)(0x40 | (player + LED_ONE - 1)), 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-                send_report_to_controller(type.dev_addr, type.instance, report, sizeof(report));
-                return;
-            }
+    for (uint8_t i = USB_HOST_PASSTHROUGH_SLOTS; i < get_usb_host_device_count(); i++) {
+        if (send_player_led_to_usb_host(i, get_usb_host_device_type(i), player)) {
+            return;
         }
     }
 #endif
@@ -363,64 +371,17 @@ void handle_rumble(uint8_t rumble_left, uint8_t rumble_right) {
 #endif
 
 #if defined(INPUT_USB_HOST) && DEVICE_TYPE == GAMEPAD
-    USB_Device_Type_t type;
-    for (uint8_t i = 0; i < get_usb_host_device_count(); i++) {
-        type = get_usb_host_device_type(i);
-        if (type.sub_type != GAMEPAD && type.sub_type != XINPUT_WHEEL) continue;
-        switch (type.console_type) {
-            case PS3: {
-                ps3_output_report *report = &ps3_output_reports[i];
-                report->rumble.left_motor_force = rumble_left;
-                report->rumble.right_motor_on = rumble_right != 0;
-                transfer_with_usb_controller(i, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0201, 0x00, sizeof(ps3_output_report), (uint8_t *)report);
-                return;
-            }
-            case PS4: {
-                ps4_output_report *report = &ps4_output_reports[i];
-                report->motor_left = rumble_left;
-                report->motor_right = rumble_right != 0;
-                send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)report, sizeof(ps4_output_report));
-                return;
-            }
-            case OG_XBOX: {
-                uint8_t rumble_packet[] = {0x00, 0x06, 0x00, rumble_left, 0x00, rumble_right};
-                send_report_to_controller(type.dev_addr, type.instance, rumble_packet, sizeof(rumble_packet));
-                return;
-            }
-            case XBOX360: {
-                XInputRumbleReport_t report = {
-                    rid : XBOX_RUMBLE_ID,
-                    rsize : sizeof(XInputRumbleReport_t),
-                    leftRumble : rumble_left,
-                    rightRumble : rumble_right
-                };
-                send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)&report, sizeof(report));
-                return;
-            }
-            case XBOX360_W: {
-                uint8_t rumble_packet[] = {0x00, 0x01, 0x0f, 0xc0, 0x00, rumble_left, rumble_right, 0x00, 0x00, 0x00, 0x00, 0x00};
-                send_report_to_controller(type.dev_addr, type.instance, rumble_packet, sizeof(rumble_packet));
-                return;
-            }
-            case XBOXONE: {
-                GipRumble_t report;
-                GipRumble_t *packet = &report;
-                GIP_HEADER(packet, GIP_CMD_RUMBLE, true, xone_sequences[i]++);
-                report.leftMotor = rumble_left;
-                report.rightMotor = rumble_right;
-                if (xone_sequences[i] == 0) {
-                    xone_sequences[i] = 1;
-                }
-                send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)&report, sizeof(report));
-            }
+    for (uint8_t i = USB_HOST_PASSTHROUGH_SLOTS; i < get_usb_host_device_count(); i++) {
+        if (send_rumble_to_usb_host(i, get_usb_host_device_type(i), rumble_left, rumble_right, false)) {
+            return;
         }
     }
 #endif
 #if defined(INPUT_USB_HOST) && DEVICE_TYPE == STAGE_KIT
     USB_Device_Type_t type;
     // Only xinput has stage kit
-    for (uint8_t i = 0; i < get_usb_host_device_count(); i++) {
-        type = get_usb_host_device_type(i);
+    for (uint64_t devices = get_usb_host_devices_for(XBOX360) | get_usb_host_devices_for(XBOX360_W); devices; devices &= devices - 1) {
+        type = get_usb_host_device_type(__builtin_ctzll(devices));
         if (type.sub_type != STAGE_KIT) continue;
         XInputRumbleReport_t report = {
             rid : XBOX_RUMBLE_ID,
@@ -461,7 +422,7 @@ void handle_rumble(uint8_t rumble_left, uint8_t rumble_right) {
                     enable : rumble_left != 0,
                     padding : {0}
                 };
-                transfer_with_usb_controller(i, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0200, 0x00, sizeof(report), (uint8_t *)&report);
+                queue_transfer_with_usb_controller(type.dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x0200, 0x00, sizeof(report), (uint8_t *)&report);
                 return;
             }
         }
@@ -559,9 +520,8 @@ void hid_set_report(const uint8_t *data, uint8_t len, uint8_t reportType, uint8_
 #endif
     uint8_t id = data[0];
 #if defined(INPUT_USB_HOST)
-    for (uint8_t i = 0; i < get_usb_host_device_count(); i++) {
-        USB_Device_Type_t type = get_usb_host_device_type(i);
-        if (type.console_type != SANTROLLER) continue;
+    for (uint64_t devices = get_usb_host_devices_for(SANTROLLER); devices; devices &= devices - 1) {
+        USB_Device_Type_t type = get_usb_host_device_type(__builtin_ctzll(devices));
         // Convert xinput payloads to their hid counterparts and send
         if ((consoleType == XBOX360 || consoleType == WINDOWS) && report_id != BLUETOOTH_REPORT) {
             uint8_t data_hid[8] = {0};
@@ -667,7 +627,7 @@ void hid_set_report(const uint8_t *data, uint8_t len, uint8_t reportType, uint8_
             delay(1);
             if (data[0] == GIP_AUTHENTICATION && len == 6 && data[3] == 2 && data[4] == 1 && data[5] == 0) {
                 handle_auth_led();
-                printf("Ready!\r\n");
+                LOG_INFO("Ready!");
                 xbox_one_state = Ready;
                 data_from_console_size = len;
                 memcpy(data_from_console, data, len);
@@ -728,9 +688,9 @@ void hid_set_report(const uint8_t *data, uint8_t len, uint8_t reportType, uint8_
 
 #if defined(INPUT_USB_HOST) && DEVICE_TYPE == GAMEPAD
                 USB_Device_Type_t type;
-                for (uint8_t i = 0; i < get_usb_host_device_count(); i++) {
-                    type = get_usb_host_device_type(i);
-                    if (type.sub_type != GAMEPAD || type.console_type != PS4) continue;
+                for (uint64_t devices = get_usb_host_devices_for(PS4); devices; devices &= devices - 1) {
+                    type = get_usb_host_device_type(__builtin_ctzll(devices));
+                    if (type.sub_type != GAMEPAD) continue;
                     send_report_to_controller(type.dev_addr, type.instance, (uint8_t *)report, sizeof(ps4_output_report));
                     return;
                 }
@@ -800,6 +760,16 @@ uint8_t handle_serial_command(uint8_t request, uint16_t wValue, uint8_t *respons
             memcpy(response_buffer, &wiiControllerType, sizeof(wiiControllerType));
             return sizeof(wiiControllerType);
         case COMMAND_GET_EXTENSION_PS2:
+#ifdef INPUT_PS2_MULTITAP
+            // With a multitap, wValue picks the port
+            if (wValue) {
+                if (wValue >= PS2_PORT_COUNT || !bit_check(lastPS2MultitapSuccessful, wValue)) {
+                    return 0;
+                }
+                response_buffer[0] = ps2PortControllerType(wValue);
+                return 1;
+            }
+#endif
             if (!lastPS2WasSuccessful) {
                 return 0;
             }
@@ -812,6 +782,15 @@ uint8_t handle_serial_command(uint8_t request, uint16_t wValue, uint8_t *respons
             memcpy(response_buffer, &lastSuccessfulWiiPacket, wiiBytes);
             return wiiBytes;
         case COMMAND_READ_PS2:
+#ifdef INPUT_PS2_MULTITAP
+            if (wValue) {
+                if (wValue >= PS2_PORT_COUNT || !bit_check(lastPS2MultitapSuccessful, wValue)) {
+                    return 0;
+                }
+                memcpy(response_buffer, lastSuccessfulPS2MultitapPackets[wValue], sizeof(lastSuccessfulPS2MultitapPackets[wValue]));
+                return sizeof(lastSuccessfulPS2MultitapPackets[wValue]);
+            }
+#endif
             if (!lastPS2WasSuccessful) {
                 return 0;
             }
@@ -847,7 +826,14 @@ uint8_t handle_serial_command(uint8_t request, uint16_t wValue, uint8_t *respons
             for (int i = 0; i < sizeof(lastWt); i++) {
                 response_buffer[i] = data[i];
             }
-            return sizeof(lastWt);
+            // Followed by the tracked baseline and noise for each pad
+            uint32_t tracked[10];
+            for (int i = 0; i < 5; i++) {
+                tracked[i] = wtBaseline(&wtBaselines[i]);
+                tracked[i + 5] = wtNoise(&wtBaselines[i]);
+            }
+            memcpy(response_buffer + sizeof(lastWt), tracked, sizeof(tracked));
+            return sizeof(lastWt) * 3;
         }
 #endif
         case COMMAND_READ_ANALOG: {
@@ -862,7 +848,10 @@ uint8_t handle_serial_command(uint8_t request, uint16_t wValue, uint8_t *respons
             return sizeof(filtered);
         }
         case COMMAND_SET_ADXL_FILTER: {
-            memcpy(&currentLowPassAlpha, response_buffer, sizeof(currentLowPassAlpha));
+            // The tool still sends a double, which is only converted once here
+            double alpha;
+            memcpy(&alpha, response_buffer, sizeof(alpha));
+            currentLowPassAlpha = ADXL_ALPHA_Q15(alpha);
             return 0;
         }
         case COMMAND_READ_DIGITAL: {
@@ -891,7 +880,12 @@ uint8_t handle_serial_command(uint8_t request, uint16_t wValue, uint8_t *respons
         }
         case COMMAND_DISABLE_MULTIPLEXER: {
             disable_multiplexer = response_buffer[0];
+            return 0;
         }
+#if LOG_LEVEL > LOG_LEVEL_NONE
+        case COMMAND_READ_LOG:
+            return logRead(response_buffer, 1 + sizeof(Log_Record_t) * 8);
+#endif
 #ifdef INPUT_MIDI
         case COMMAND_READ_MIDI: {
             memcpy(response_buffer, &midiData, sizeof(Midi_Data_t));
@@ -1034,6 +1028,9 @@ uint8_t handle_serial_command(uint8_t request, uint16_t wValue, uint8_t *respons
         case COMMAND_READ_USB_HOST: {
             return read_usb_host_devices(response_buffer);
         }
+        case COMMAND_READ_USB_HOST_HID_STATUS: {
+            return read_usb_host_hid_status(response_buffer);
+        }
         case COMMAND_READ_USB_HOST_INPUTS: {
             memcpy(response_buffer, &last_usb_host_data, sizeof(last_usb_host_data));
             return sizeof(last_usb_host_data);
@@ -2,18 +2,46 @@
 #include "adxl.h"
 #include "fxpt_math.h"
 #include "config.h"
+#include "pin_funcs.h"
 int16_t filtered[3] = {0};
-double currentLowPassAlpha = LOW_PASS_ALPHA;
+int16_t currentLowPassAlpha = ADXL_ALPHA_Q15(LOW_PASS_ALPHA);
 #ifdef INPUT_ADXL
 void init_adxl() {
+    uint8_t format = 0x0B;
+#ifdef ADXL_INTERRUPT
+    // Run INT1 active low so an unconnected line just reads as idle on the pullup
+    pin_init_pullup(ADXL_INTERRUPT);
+    format |= ADXL345_INT_INVERT;
+#endif
+    twi_writeSingleToPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_DATA_FORMAT, format);
+    // Keep every sample in the FIFO, and raise the watermark interrupt on INT1 as soon as one is waiting
+    twi_writeSingleToPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_FIFO_CTL, ADXL345_FIFO_STREAM | 1);
+    twi_writeSingleToPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_INT_MAP, 0x00);
+    twi_writeSingleToPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_INT_ENABLE, ADXL345_INT_WATERMARK);
     twi_writeSingleToPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_POWER_CTL, 0x08);
-    twi_writeSingleToPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_DATA_FORMAT, 0x0B);
 }
 void tick_adxl() {
-    int16_t raw[3];
-    twi_readFromPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_DATAX0, 6, (uint8_t*)raw);
-    for (int i = 0; i < 3; i++) {
-        filtered[i] = (raw[i] * 64) * currentLowPassAlpha + (filtered[i] * (1.0 - currentLowPassAlpha));
+#ifdef ADXL_INTERRUPT
+    if (pin_read(ADXL_INTERRUPT)) {
+        return;
+    }
+#endif
+    uint8_t status;
+    if (!twi_readFromPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_FIFO_STATUS, 1, &status)) {
+        return;
+    }
+    // Each read of the data registers pops one entry from the FIFO
+    for (uint8_t entries = status & ADXL345_FIFO_ENTRIES; entries; entries--) {
+        int16_t raw[3];
+        if (!twi_readFromPointer(ADXL_TWI_PORT, ADXL345_ADDRESS, ADXL345_DATAX0, 6, (uint8_t*)raw)) {
+            return;
+        }
+        // Full resolution is 256 LSB per g, which is scaled so that 1 g is 16384. Only +-2 g fits in
+        // 16 bits after that, so harder hits are saturated by fxpt_lowpass. Tilt only needs +-1 g, and
+        // clipping a hit keeps it from swinging the filtered value as far.
+        for (int i = 0; i < 3; i++) {
+            filtered[i] = fxpt_lowpass(filtered[i], raw[i] * 64L, currentLowPassAlpha);
+        }
     }
 }
-#endif
\ No newline at end of file
+#endif
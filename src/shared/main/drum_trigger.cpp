@@ -0,0 +1,107 @@
+#include "drum_trigger.h"
+
+#include "config.h"
+#ifdef INPUT_DRUM_TRIGGER
+enum {
+    DRUM_TRIGGER_IDLE,
+    DRUM_TRIGGER_SCAN,
+    DRUM_TRIGGER_MASKED
+};
+typedef struct {
+    uint8_t state;
+    uint16_t peak;
+    uint16_t remaining;
+} Drum_Trigger_t;
+static Drum_Trigger_t triggers[DRUM_TRIGGER_CHANNELS];
+// Written by the ADC interrupt and read by the tick, each side only moves its own index
+static Drum_Trigger_Event_t queue[DRUM_TRIGGER_QUEUE_SIZE];
+static volatile uint8_t queueHead = 0;
+static volatile uint8_t queueTail = 0;
+// The hit each pad is currently holding, only touched by the tick
+static Drum_Trigger_Event_t held[DRUM_TRIGGER_CHANNELS];
+// Loudest recent hit, used for crosstalk rejection
+static uint16_t lastHitPeak = 0;
+static uint16_t lastHitRemaining = 0;
+static uint8_t lastHitChannel = 0;
+
+bool drumTriggerSample(uint8_t channel, uint16_t value) {
+    Drum_Trigger_t *trigger = &triggers[channel];
+    if (channel == lastHitChannel && lastHitRemaining) {
+        lastHitRemaining--;
+    }
+    switch (trigger->state) {
+        case DRUM_TRIGGER_IDLE:
+            if (value < DRUM_TRIGGER_THRESHOLD) {
+                return false;
+            }
+            trigger->state = DRUM_TRIGGER_SCAN;
+            trigger->peak = value;
+            trigger->remaining = DRUM_TRIGGER_SCAN_SAMPLES;
+            return false;
+        case DRUM_TRIGGER_SCAN:
+            if (value > trigger->peak) {
+                trigger->peak = value;
+            }
+            if (--trigger->remaining) {
+                return false;
+            }
+            trigger->state = DRUM_TRIGGER_MASKED;
+            trigger->remaining = DRUM_TRIGGER_RETRIGGER_SAMPLES;
+            if (channel != lastHitChannel && lastHitRemaining && trigger->peak < ((uint32_t)lastHitPeak * DRUM_TRIGGER_CROSSTALK) >> 8) {
+                return false;
+            }
+            lastHitPeak = trigger->peak;
+            lastHitChannel = channel;
+            lastHitRemaining = DRUM_TRIGGER_SCAN_SAMPLES;
+            return true;
+        case DRUM_TRIGGER_MASKED:
+            if (!--trigger->remaining) {
+                trigger->state = DRUM_TRIGGER_IDLE;
+            }
+            return false;
+    }
+    return false;
+}
+
+void drumTriggerHit(uint8_t channel, uint32_t time) {
+    uint8_t next = (queueHead + 1) & (DRUM_TRIGGER_QUEUE_SIZE - 1);
+    // If the tick has fallen that far behind, the newest hit is dropped
+    if (next == queueTail) {
+        return;
+    }
+    Drum_Trigger_Event_t *event = &queue[queueHead];
+    event->time = time;
+    event->velocity = triggers[channel].peak;
+    event->channel = channel;
+    // Make sure the event is written out before the tick can see it
+    asm volatile("" ::: "memory");
+    queueHead = next;
+}
+
+bool drumTriggerPop(Drum_Trigger_Event_t *event) {
+    if (queueTail == queueHead) {
+        return false;
+    }
+    asm volatile("" ::: "memory");
+    *event = queue[queueTail];
+    queueTail = (queueTail + 1) & (DRUM_TRIGGER_QUEUE_SIZE - 1);
+    return true;
+}
+
+void drumTriggerTick(uint32_t now) {
+    Drum_Trigger_Event_t event;
+    while (drumTriggerPop(&event)) {
+        held[event.channel] = event;
+    }
+    // The hold is timed from when the ADC saw the hit, not from when it was first read
+    for (uint8_t i = 0; i < DRUM_TRIGGER_CHANNELS; i++) {
+        if (held[i].velocity && now - held[i].time > DRUM_TRIGGER_HOLD_US) {
+            held[i].velocity = 0;
+        }
+    }
+}
+
+uint16_t drumTriggerRead(uint8_t channel) {
+    return held[channel].velocity;
+}
+#endif
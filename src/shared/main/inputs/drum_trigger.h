@@ -0,0 +1,4 @@
+#ifdef INPUT_DRUM_TRIGGER
+    // Hits queued by the ADC interrupt are picked up here, and held for the report and MIDI paths
+    drumTriggerTick(micros());
+#endif
\ No newline at end of file
@@ -28,5 +28,15 @@
             lastTapPS2GH5 = 0xFF;
         }
     }
-    
+#ifdef INPUT_PS2_MULTITAP
+    // Each multitap port gets its own slot, so inputs can be mapped from any of them
+    lastPS2MultitapSuccessful = 0;
+    for (uint8_t ps2Port = 0; ps2Port < PS2_PORT_COUNT; ps2Port++) {
+        uint8_t *ps2PortPacket = ps2PortData(ps2Port);
+        if (ps2PortPacket != NULL) {
+            bit_set(lastPS2MultitapSuccessful, ps2Port);
+            memcpy(lastSuccessfulPS2MultitapPackets[ps2Port], ps2PortPacket, BUFFER_SIZE);
+        }
+    }
+#endif
 #endif
\ No newline at end of file
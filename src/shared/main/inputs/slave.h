@@ -4,13 +4,24 @@
 #include "commands.h"
 #include "config.h"
 #include "io.h"
+#include "pin_funcs.h"
 #include "pico_slave.h"
 #define RETRY_COUNT 2
 #ifdef SLAVE_TWI_PORT
+Slave_Snapshot_t slaveSnapshot;
+// The peripheral remembers the last command it was sent, so as long as nothing else has been
+// sent since the last snapshot, the next one can be read without writing the command again.
+bool slaveSnapshotSelected = false;
+// Cleared whenever the peripheral is initialised, as its sequence number starts over
+bool slaveSnapshotValid = false;
+#ifdef SLAVE_INTERRUPT
+long lastSlaveSnapshot = 0;
+#endif
 void slavePinMode(uint8_t pin, uint8_t pinMode) {
     if (!slave_initted) {
         return;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         uint8_t payload[] = {pin, pinMode};
         slave_initted = twi_writeToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_SET_PINMODE, sizeof(payload), payload);
@@ -24,6 +35,7 @@ uint32_t slaveReadDigital() {
     if (!slave_initted) {
         return 0;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         uint32_t payload = 0;
         slave_initted = twi_readFromPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_GET_DIGITAL, sizeof(payload), (uint8_t*)&payload);
@@ -38,6 +50,7 @@ uint8_t slaveReadDigital(uint8_t port, uint8_t mask) {
     if (!slave_initted) {
         return 0;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         uint8_t payload2[2] = {port, mask};
         slave_initted = twi_writeToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_GET_DIGITAL_PIN_2, sizeof(payload2), payload2);
@@ -59,9 +72,10 @@ void slaveWriteDigital(uint8_t pin, bool output) {
     if (!slave_initted) {
         return;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         uint8_t payload[] = {pin, output};
-        slave_initted = (SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_SET_PIN, sizeof(payload), payload);
+        slave_initted = twi_writeToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_SET_PIN, sizeof(payload), payload);
         if (slave_initted) {
             return;
         }
@@ -72,6 +86,7 @@ void slaveInitLED(uint8_t instance) {
     if (!slave_initted) {
         return;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         slave_initted = twi_writeSingleToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_INIT_SPI, instance);
         if (slave_initted) {
@@ -80,15 +95,33 @@ void slaveInitLED(uint8_t instance) {
     }
 }
 
+// LED data is collected into a frame and sent in as few transactions as possible,
+// instead of one transaction per byte
+uint8_t slaveLedFrame[SLAVE_SPI_FRAME_MAX];
+uint8_t slaveLedFrameLength = 0;
+void slaveFlushLED() {
+    if (!slaveLedFrameLength) {
+        return;
+    }
+    if (slave_initted) {
+        slaveSnapshotSelected = false;
+        for (int i = 0; i < RETRY_COUNT; i++) {
+            slave_initted = twi_writeToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_WRITE_SPI_FRAME, slaveLedFrameLength, slaveLedFrame);
+            if (slave_initted) {
+                break;
+            }
+        }
+    }
+    slaveLedFrameLength = 0;
+}
+
 void slaveWriteLED(uint8_t data) {
     if (!slave_initted) {
         return;
     }
-    for (int i = 0; i < RETRY_COUNT; i++) {
-        slave_initted = twi_writeSingleToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_WRITE_SPI, data);
-        if (slave_initted) {
-            return;
-        }
+    slaveLedFrame[slaveLedFrameLength++] = data;
+    if (slaveLedFrameLength == sizeof(slaveLedFrame)) {
+        slaveFlushLED();
     }
 }
 
@@ -96,6 +129,7 @@ uint8_t slaveReadWt() {
     if (!slave_initted) {
         return 0;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         uint8_t data = 0;
         slave_initted = twi_readFromPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_GET_WT, sizeof(data), &data);
@@ -110,15 +144,74 @@ uint8_t slaveReadWtRaw(uint8_t* output) {
     if (!slave_initted) {
         return 0;
     }
+    // Raw counts are part of the snapshot, so only the tracked baselines and noise are read from the peripheral.
+    // This matches the layout of COMMAND_READ_GHWT: raw counts, then baselines, then noise.
+    uint32_t* raw = (uint32_t*)output;
+    for (int i = 0; i < SLAVE_WT_COUNT; i++) {
+        raw[i] = slaveSnapshot.wtRaw[i];
+    }
+    uint16_t tracked[SLAVE_WT_COUNT * 2] = {0};
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
-        slave_initted = twi_readFromPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_GET_WT_RAW, 5 * sizeof(uint32_t), output);
+        slave_initted = twi_readFromPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_GET_WT_TRACKING, sizeof(tracked), (uint8_t*)tracked);
         if (slave_initted) {
-            return 5 * sizeof(uint32_t);
+            break;
         }
     }
-    return 0;
+    for (int i = 0; i < SLAVE_WT_COUNT * 2; i++) {
+        raw[i + SLAVE_WT_COUNT] = tracked[i];
+    }
+    return SLAVE_WT_COUNT * 3 * sizeof(uint32_t);
+}
+// Analog channels are only converted by the peripheral once they have been set to PIN_MODE_ANALOG,
+// and only the pins on ADC channels 0 - 2 can be read.
+uint16_t slaveReadAnalog(uint8_t channel) {
+    if (channel >= SLAVE_ANALOG_COUNT) {
+        return 0;
+    }
+    return slaveSnapshot.analog[channel];
+}
+bool slaveReadSnapshot() {
+    if (!slave_initted) {
+        return false;
+    }
+#ifdef SLAVE_INTERRUPT
+    // The peripheral pulls the interrupt line low when its digital pins or WT neck change,
+    // so at rest we only need to check in occasionally
+    if (pin_read(SLAVE_INTERRUPT) && millis() - lastSlaveSnapshot < SLAVE_HEARTBEAT_INTERVAL) {
+        return false;
+    }
+    lastSlaveSnapshot = millis();
+#endif
+    for (int i = 0; i < RETRY_COUNT; i++) {
+        Slave_Snapshot_t snapshot;
+        if (slaveSnapshotSelected) {
+            slave_initted = twi_readFrom(SLAVE_TWI_PORT, SLAVE_ADDR, (uint8_t*)&snapshot, sizeof(snapshot), true);
+        } else {
+            slave_initted = twi_readFromPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_GET_SNAPSHOT, sizeof(snapshot), (uint8_t*)&snapshot);
+        }
+        if (!slave_initted) {
+            slaveSnapshotSelected = false;
+            continue;
+        }
+        slaveSnapshotSelected = true;
+        // A corrupted frame is dropped, and the last good snapshot is kept
+        if (snapshot.header != SLAVE_COMMAND_GET_SNAPSHOT || snapshot.checksum != slaveSnapshotChecksum(&snapshot)) {
+            return false;
+        }
+        // The sequence only changes when the contents do, so an unchanged snapshot can be skipped
+        if (slaveSnapshotValid && snapshot.sequence == slaveSnapshot.sequence) {
+            return false;
+        }
+        memcpy(&slaveSnapshot, &snapshot, sizeof(snapshot));
+        slaveSnapshotValid = true;
+        return true;
+    }
+    return false;
 }
 bool slaveInit() {
+    slaveSnapshotSelected = false;
+    slaveSnapshotValid = false;
     uint8_t data;
     twi_readFromPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_INITIALISE, sizeof(data), &data);
     return data == SLAVE_COMMAND_INITIALISE;
@@ -128,6 +221,7 @@ void slaveInitWt() {
     if (!slave_initted) {
         return;
     }
+    slaveSnapshotSelected = false;
     for (int i = 0; i < RETRY_COUNT; i++) {
         uint8_t payload[] = {WT_PIN_INPUT, WT_PIN_S0, WT_PIN_S1, WT_PIN_S2, WT_SENSITIVITY >> 8, WT_SENSITIVITY & 0xFF};
         slave_initted = twi_writeToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_INIT_WT, sizeof(payload), payload);
@@ -137,4 +231,19 @@ void slaveInitWt() {
     }
 #endif
 }
-#endif
\ No newline at end of file
+void slaveInitInterrupt() {
+#ifdef SLAVE_INTERRUPT
+    if (!slave_initted) {
+        return;
+    }
+    slaveSnapshotSelected = false;
+    pin_init_pullup(SLAVE_INTERRUPT);
+    for (int i = 0; i < RETRY_COUNT; i++) {
+        slave_initted = twi_writeSingleToPointer(SLAVE_TWI_PORT, SLAVE_ADDR, SLAVE_COMMAND_INIT_INTERRUPT, SLAVE_INTERRUPT_PERIPHERAL);
+        if (slave_initted) {
+            return;
+        }
+    }
+#endif
+}
+#endif
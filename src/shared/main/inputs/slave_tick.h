@@ -1,4 +1,5 @@
-
 #ifdef SLAVE_TWI_PORT
-    uint32_t slave_digital = slaveReadDigital();
+    // Digital pins, the WT neck and analog channels all come from one snapshot per tick
+    slaveReadSnapshot();
+    uint32_t slave_digital = slaveSnapshot.digital;
 #endif
\ No newline at end of file
@@ -14,71 +14,32 @@ if (elapsed) {
     lastTurntableWasSuccessfulLeft = djLeftValid;
     lastTurntableWasSuccessfulRight = djRightValid;
 }
-#ifdef CONFIGURABLE_BLOBS
-
+// DJ Hero turntables are pretty noisy, so smooth that out
 if (djLeftValid) {
-    if (INPUT_DJ_TURNTABLE_SMOOTHING) {
+#ifdef INPUT_DJ_TURNTABLE_SMOOTHING
+    if (INPUT_DJ_TURNTABLE_SMOOTHING_LEFT) {
         if (elapsed) {
-            dj_sum_left -= dj_last_readings_left[dj_next_left];
-            dj_last_readings_left[dj_next_left] = (int8_t)dj_left[2];
-            dj_sum_left += dj_last_readings_left[dj_next_left];
-            dj_next_left++;
-            if (dj_next_left >= TURNTABLE_BUFFER_SIZE) {
-                dj_next_left = 0;
-            }
+            smoothTurntable(&dj_smoothing_left, (int8_t)dj_left[2]);
         }
-        dj_turntable_left = (dj_sum_left / TURNTABLE_BUFFER_SIZE);
-    } else {
+        dj_turntable_left = smoothedTurntable(&dj_smoothing_left);
+    } else
+#endif
+    {
         dj_turntable_left = (int8_t)dj_left[2];
     }
 }
 if (djRightValid) {
-    if (INPUT_DJ_TURNTABLE_SMOOTHING) {
+#ifdef INPUT_DJ_TURNTABLE_SMOOTHING
+    if (INPUT_DJ_TURNTABLE_SMOOTHING_RIGHT) {
         if (elapsed) {
-            dj_sum_right -= dj_last_readings_right[dj_next_right];
-            dj_last_readings_right[dj_next_right] = (int8_t)dj_right[2];
-            dj_sum_right += dj_last_readings_right[dj_next_right];
-            dj_next_right++;
-            if (dj_next_right >= TURNTABLE_BUFFER_SIZE) {
-                dj_next_right = 0;
-            }
+            smoothTurntable(&dj_smoothing_right, (int8_t)dj_right[2]);
         }
-    } else {
+        dj_turntable_right = smoothedTurntable(&dj_smoothing_right);
+    } else
+#endif
+    {
         dj_turntable_right = (int8_t)dj_right[2];
     }
 }
 
-#else
-// DJ Hero turntables are pretty noisy, so smooth that out with a moving average
-#if INPUT_DJ_TURNTABLE_SMOOTHING
-if (djLeftValid) {
-    if (elapsed) {
-        dj_sum_left -= dj_last_readings_left[dj_next_left];
-        dj_last_readings_left[dj_next_left] = (int8_t)dj_left[2];
-        dj_sum_left += dj_last_readings_left[dj_next_left];
-        dj_next_left++;
-        if (dj_next_left >= TURNTABLE_BUFFER_SIZE) {
-            dj_next_left = 0;
-        }
-    }
-    dj_turntable_left = (dj_sum_left / TURNTABLE_BUFFER_SIZE);
-}
-if (djRightValid) {
-    if (elapsed) {
-        dj_sum_right -= dj_last_readings_right[dj_next_right];
-        dj_last_readings_right[dj_next_right] = (int8_t)dj_right[2];
-        dj_sum_right += dj_last_readings_right[dj_next_right];
-        dj_next_right++;
-        if (dj_next_right >= TURNTABLE_BUFFER_SIZE) {
-            dj_next_right = 0;
-        }
-    }
-    dj_turntable_right = (dj_sum_right / TURNTABLE_BUFFER_SIZE);
-}
-#else
-dj_turntable_left = (int8_t)dj_left[2];
-dj_turntable_right = (int8_t)dj_right[2];
-#endif
-#endif
-
 #endif
\ No newline at end of file
@@ -1,5 +1,5 @@
 #ifdef INPUT_WT_SLAVE_NECK
-    rawWtPeripheral = slaveReadWt();
+    rawWtPeripheral = slaveSnapshot.wt;
 #endif
 #ifdef INPUT_WT_NECK
     rawWt = tickWt();
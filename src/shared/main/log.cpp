@@ -0,0 +1,80 @@
+#include "log.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "Arduino.h"
+#if LOG_LEVEL > LOG_LEVEL_NONE
+#if SUPPORTS_PICO
+#include "pico/critical_section.h"
+// Both cores log, so masking interrupts on one of them isn't enough
+static critical_section_t logLock;
+// Claimed before main, as core1 can start logging while setup() is still running
+static void __attribute__((constructor)) logInit() {
+    critical_section_init(&logLock);
+}
+#define LOG_LOCK() critical_section_enter_blocking(&logLock)
+#define LOG_UNLOCK() critical_section_exit(&logLock)
+#else
+#define LOG_LOCK() noInterrupts()
+#define LOG_UNLOCK() interrupts()
+#endif
+Log_Record_t logBuffer[LOG_BUFFER_SIZE];
+volatile uint8_t logHead = 0;
+volatile uint8_t logTail = 0;
+volatile uint8_t logDropped = 0;
+
+void logWrite(const char* format, uint32_t a, uint32_t b, uint32_t c, uint32_t d) {
+    LOG_LOCK();
+    uint8_t next = (logHead + 1) % LOG_BUFFER_SIZE;
+    if (next == logTail) {
+        // Keep the oldest records, they are usually the interesting ones
+        if (logDropped != UINT8_MAX) {
+            logDropped++;
+        }
+        LOG_UNLOCK();
+        return;
+    }
+    Log_Record_t* record = &logBuffer[logHead];
+    record->format = (uintptr_t)format;
+    record->timestamp = micros();
+    record->args[0] = a;
+    record->args[1] = b;
+    record->args[2] = c;
+    record->args[3] = d;
+    logHead = next;
+    LOG_UNLOCK();
+}
+
+uint8_t logRead(uint8_t* dest, uint8_t length) {
+    uint8_t written = 0;
+    // The first byte says how many records were lost since the last read
+    if (!length) {
+        return 0;
+    }
+    LOG_LOCK();
+    dest[written++] = logDropped;
+    logDropped = 0;
+    while (logTail != logHead && length - written >= sizeof(Log_Record_t)) {
+        memcpy(dest + written, &logBuffer[logTail], sizeof(Log_Record_t));
+        written += sizeof(Log_Record_t);
+        logTail = (logTail + 1) % LOG_BUFFER_SIZE;
+    }
+    LOG_UNLOCK();
+    return written;
+}
+
+void logPrintPending() {
+    LOG_LOCK();
+    if (logTail == logHead) {
+        LOG_UNLOCK();
+        return;
+    }
+    Log_Record_t record = logBuffer[logTail];
+    logTail = (logTail + 1) % LOG_BUFFER_SIZE;
+    LOG_UNLOCK();
+    printf("[%lu] ", (unsigned long)record.timestamp);
+    printf((const char*)(uintptr_t)record.format, record.args[0], record.args[1], record.args[2], record.args[3]);
+    printf("\r\n");
+}
+#endif
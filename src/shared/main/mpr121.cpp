@@ -2,8 +2,11 @@
 
 #include "config.h"
 #include "io.h"
+#include "pin_funcs.h"
 #ifdef MPR121_TWI_PORT
 bool mpr121_init = false;
+static uint16_t mpr121_last = 0;
+static bool mpr121_first = false;
 bool init_mpr121() {
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_SOFTRESET, 0x63);
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_ECR, 0x0);
@@ -14,28 +17,24 @@ bool init_mpr121() {
     }
     mpr121_init = true;
     for (uint8_t i = 0; i < MPR121_TOUCHPADS; i++) {
-        twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_TOUCHTH_0 + 2 * i, MPR121_TOUCH_THRESHOLD_DEFAULT);
-        twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_RELEASETH_0 + 2 * i, MPR121_RELEASE_THRESHOLD_DEFAULT);
+        twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_TOUCHTH_0 + 2 * i, MPR121_TOUCH_THRESHOLD);
+        twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_RELEASETH_0 + 2 * i, MPR121_RELEASE_THRESHOLD);
     }
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_MHDR, 0x01);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_NHDR, 0x01);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_NCLR, 0x0E);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_FDLR, 0x00);
-
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_MHDF, 0x01);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_NHDF, 0x05);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_NCLF, 0x01);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_FDLF, 0x00);
+    // MHD, NHD, NCL and FDL are consecutive registers for both directions
+    uint8_t rising[] = {MPR121_BASELINE_RISING};
+    uint8_t falling[] = {MPR121_BASELINE_FALLING};
+    twi_writeToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_MHDR, sizeof(rising), rising);
+    twi_writeToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_MHDF, sizeof(falling), falling);
 
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_NHDT, 0x00);
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_NCLT, 0x00);
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_FDLT, 0x00);
 
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_DEBOUNCE, 0);
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_CONFIG1, 0x10);  // default, 16uA charge current
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_CONFIG2, 0x20);
+    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_DEBOUNCE, (MPR121_DEBOUNCE_RELEASE << 4) | MPR121_DEBOUNCE_TOUCH);
+    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_CONFIG1, (MPR121_FFI << 6) | 0x10);  // 16uA charge current
+    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_CONFIG2, 0x20 | (MPR121_SFI << 3) | MPR121_ESI);
 
-    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_AUTOCONFIG0, 0x0B);
+    twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_AUTOCONFIG0, (MPR121_FFI << 6) | 0x0B);  // FFI has to match CONFIG1 for autoconfig
 
     // correct values for Vdd = 3.3V
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_UPLIMIT, 200);      // ((Vdd - 0.7)/Vdd) * 256
@@ -51,19 +50,33 @@ bool init_mpr121() {
 #endif
     // enable electrodes and start MPR121
     uint8_t ECR_SETTING =
-        0b10000000 + MPR121_TOUCHPADS;                                                           // 5 bits for baseline tracking & proximity disabled + X
+        (MPR121_BASELINE_TRACKING << 6) + MPR121_TOUCHPADS;                                      // baseline tracking & proximity disabled + X
                                                                                                  // amount of electrodes running (12)
     twi_writeSingleToPointer(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_ECR, ECR_SETTING);  // start with above ECR setting
+#ifdef MPR121_INTERRUPT
+    // IRQ is open drain and active low, and is cleared by reading the touch status
+    pin_init_pullup(MPR121_INTERRUPT);
+#endif
+    mpr121_first = true;
     return true;
 }
 uint16_t tick_mpr121() {
     if (!mpr121_init && !init_mpr121()) {
         return 0;
     }
+#ifdef MPR121_INTERRUPT
+    // Nothing has changed since the last read
+    if (!mpr121_first && pin_read(MPR121_INTERRUPT)) {
+        return mpr121_last;
+    }
+#endif
     uint16_t raw;
     if (!twi_readFromPointerRepeatedStart(MPR121_TWI_PORT, MPR121_I2CADDR_DEFAULT, MPR121_TOUCHSTATUS_L, sizeof(raw), (uint8_t*)&raw)) {
         mpr121_init = false;
+        return mpr121_last;
     }
+    mpr121_first = false;
+    mpr121_last = raw;
     return raw;
 }
 #endif
\ No newline at end of file
@@ -8,10 +8,6 @@
 #include "util.h"
 #ifdef INPUT_PS2
 
-static inline bool isValidReply(const uint8_t *status) {
-    return status[1] != 0xFF && (status[2] == 0x5A || status[2] == 0x00);
-}
-
 static inline bool isFlightStickReply(const uint8_t *status) {
     return (status[1] & 0xF0) == 0x50;
 }
@@ -86,9 +82,64 @@ static const uint8_t commandSetPressuresMouse[] = {0x4F, 0x00, 0b1111, 0x00,
 
 static const uint8_t commandPollInput[] = {0x42, 0x00, 0xFF, 0xFF};
 
-static bool initialised = false;
-static long last = 0;
-static uint8_t invalidCount = 0;
+#define PS2_EXPECT_ANY 0
+#define PS2_EXPECT_CONFIG 1
+#define PS2_EXPECT_NORMAL 2
+typedef struct {
+    const uint8_t *command;
+    uint8_t len;
+    uint8_t expect;
+} PS2ScriptStep_t;
+
+// Commands sent to a controller once it has been found. Each step is retried
+// every COMMAND_RETRY_INTERVAL until the expected reply is seen or the step
+// times out after COMMAND_TIMEOUT. One step is issued per tick, so the init
+// sequence never blocks the main loop.
+static const PS2ScriptStep_t initScript[] = {
+    {commandEnterConfig, sizeof(commandEnterConfig), PS2_EXPECT_CONFIG},
+    // Enable analog sticks
+    {commandSetMode, sizeof(commandSetMode), PS2_EXPECT_ANY},
+    // Enable pressure sensitive buttons
+    {commandSetPressures, sizeof(commandSetPressures), PS2_EXPECT_ANY},
+    {commandExitConfig, sizeof(commandExitConfig), PS2_EXPECT_NORMAL}};
+#define INIT_SCRIPT_LEN (sizeof(initScript) / sizeof(initScript[0]))
+
+enum PS2State {
+    PS2_STATE_PROBE,
+    PS2_STATE_SCRIPT,
+    PS2_STATE_DETECT,
+    PS2_STATE_POLL
+};
+
+typedef struct {
+    bool initialised;
+    bool exitConfigQueued;
+    uint8_t state;
+    uint8_t scriptStep;
+    uint8_t invalidCount;
+    uint8_t controllerType;
+    long last;
+    unsigned long stepStart;
+    unsigned long lastAttempt;
+    uint8_t buffer[BUFFER_SIZE];
+} PS2Port_t;
+
+static const uint8_t portAddresses[PS2_PORT_COUNT] = {
+    A,
+#ifdef INPUT_PS2_MULTITAP
+    B,
+    C,
+    D,
+#endif
+};
+static PS2Port_t ports[PS2_PORT_COUNT];
+// Which port each transfer in the current sweep belongs to
+static uint8_t sweepPorts[PS2_PORT_COUNT];
+static uint8_t sweepCount = 0;
+
+#if !PS2_PIO
+static uint8_t inputBuffer[PS2_PORT_COUNT][BUFFER_SIZE];
+static uint8_t *lastReply[PS2_PORT_COUNT];
 void noAttention(void) {
     spi_high(PS2_SPI_PORT);
     INPUT_PS2_ATT_SET();
@@ -117,9 +168,7 @@ void shiftDataInOut(const uint8_t *out, uint8_t *in, const uint8_t len) {
         }
     }
 }
-static uint8_t inputBuffer[BUFFER_SIZE];
-static uint8_t inputBuffer2[BUFFER_SIZE];
-uint8_t *autoShiftData(uint8_t port, const uint8_t *out, const uint8_t len) {
+uint8_t *autoShiftData(uint8_t port, const uint8_t *out, const uint8_t len, uint8_t *inputBuffer) {
     uint8_t *ret = NULL;
 
     if (len >= 2 && len <= BUFFER_SIZE) {
@@ -127,131 +176,219 @@ uint8_t *autoShiftData(uint8_t port, const uint8_t *out, const uint8_t len) {
         // All commands have at least 3 bytes, so shift out those first
         shiftDataInOut(&port, inputBuffer, 1);
         shiftDataInOut(out, inputBuffer + 1, 2);
-        if (isValidReply(inputBuffer)) {
-            // Reply is good, get full length
-            uint8_t replyLen = (inputBuffer[1] & 0x0F) * 2;
-
-            uint8_t left = replyLen - (len - 2);
-            // Shift out rest of command
+        uint8_t replyLen = ps2ReplyBodyLength(inputBuffer, len);
+        if (replyLen) {
+            // Shift out rest of command, and then clock in whatever is left of the reply
             shiftDataInOut(out + 2, inputBuffer + 3, len - 2);
-
-            if (left == 0) {
-                // The whole reply was gathered
-                ret = inputBuffer;
-            } else if (len + left <= BUFFER_SIZE) {
-                // Part of reply is still missing and we have space for it
-                shiftDataInOut(NULL, inputBuffer + len + 1, left);
-                ret = inputBuffer;
-            } else {
-                // Reply incomplete but not enough space provided
-            }
+            shiftDataInOut(NULL, inputBuffer + len + 1, replyLen - (len - 2));
+            ret = inputBuffer;
         }
         noAttention();
     }
     return ret;
 }
-bool sendCommand(uint8_t port, const uint8_t *buf, uint8_t len) {
-    bool ret = false;
-    unsigned long start = millis();
-    do {
-        uint8_t *in = autoShiftData(port, buf, len);
-        /* We can't know if we have successfully enabled analog mode until
-         * we get out of config mode, so let's just be happy if we get a few
-         * consecutive valid replies
-         */
-        if (in != NULL) {
-            if (buf == commandEnterConfig) {
-                ret = isConfigReply(in);
-            } else if (buf == commandExitConfig) {
-                ret = !isConfigReply(in);
-            }
-        }
 
-        if (!ret) {
-            delay(COMMAND_RETRY_INTERVAL);
-        }
-    } while (!ret && millis() - start <= COMMAND_TIMEOUT);
-    return ret;
+// Without a PIO engine, transfers are done synchronously over SPI
+void ps2TransportInit(void) {
 }
-extern unsigned long millis_at_boot;
-uint8_t *tickPS2() {
-    uint8_t *in;
-    // PS2 guitars die if you poll them too fast
-    if (ps2ControllerType == PSX_GUITAR_HERO_CONTROLLER && micros() - last < 3000) {
-        return inputBuffer;
+bool ps2TransportBusy(void) {
+    return false;
+}
+void ps2TransportStart(const PS2Transfer_t *transfers, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        lastReply[i] = autoShiftData(transfers[i].port, transfers[i].command, transfers[i].len, inputBuffer[i]);
     }
-    // If this is changed to a different port, you can talk to different devices
-    // on a multitap. Not sure how useful this is unless we make a ps2 variant
-    // that works with the multitap, and offers four devices
-    uint8_t port = A;
-    if (!initialised) {
-        if (!autoShiftData(port, commandPollInput, sizeof(commandPollInput))) {
-            initialised = false;
-            return NULL;
+}
+uint8_t *ps2TransportReply(uint8_t index) {
+    return lastReply[index];
+}
+#endif
+
+static void detectController(PS2Port_t *port, const uint8_t *in) {
+    if (isDualShock2Reply(in)) {
+        uint16_t buttonWord = ~(((uint16_t)in[4] << 8) | in[3]);
+        if (bit_check(buttonWord, PSB_PAD_LEFT)) {
+            port->controllerType = PSX_GUITAR_HERO_CONTROLLER;
+        } else {
+            port->controllerType = PSX_DUALSHOCK_2_CONTROLLER;
         }
-        if (sendCommand(port, commandEnterConfig, sizeof(commandEnterConfig))) {
-            // Enable analog sticks
-            sendCommand(port, commandSetMode, sizeof(commandSetMode));            
-            // Enable pressure sensitive buttons
-            // Some PS2 controllers are stupid and *really* need to be told to enable pressure sensitivity
-            // for (int i = 0; i < 20; i++) {
-            sendCommand(port, commandSetPressures, sizeof(commandSetPressures));
-            // }
-            sendCommand(port, commandExitConfig, sizeof(commandExitConfig));
+    } else if (isDualShockReply(in)) {
+        uint16_t buttonWord = ~(((uint16_t)in[4] << 8) | in[3]);
+        if (bit_check(buttonWord, PSB_PAD_LEFT)) {
+            port->controllerType = PSX_GUITAR_HERO_CONTROLLER;
+        } else {
+            port->controllerType = PSX_DUALSHOCK_1_CONTROLLER;
         }
-        uint8_t *in =
-            autoShiftData(port, commandPollInput, sizeof(commandPollInput));
-        if (isDualShock2Reply(in)) {
-            uint16_t buttonWord = ~(((uint16_t)in[4] << 8) | in[3]);
-            if (bit_check(buttonWord, PSB_PAD_LEFT)) {
-                ps2ControllerType = PSX_GUITAR_HERO_CONTROLLER;
-            } else {
-                ps2ControllerType = PSX_DUALSHOCK_2_CONTROLLER;
+    } else if (isFlightStickReply(in)) {
+        port->controllerType = PSX_FLIGHTSTICK;
+    } else if (isNegconReply(in)) {
+        port->controllerType = PSX_NEGCON;
+    } else if (isJogconReply(in)) {
+        port->controllerType = PSX_JOGCON;
+    } else if (isGunconReply(in)) {
+        port->controllerType = PSX_GUNCON;
+    } else if (isMouseReply(in)) {
+        port->controllerType = PSX_MOUSE;
+    } else if (isDigitalReply(in)) {
+        port->controllerType = PSX_DIGITAL;
+    }
+}
+
+static void nextScriptStep(PS2Port_t *port) {
+    port->scriptStep++;
+    port->stepStart = millis();
+    if (port->scriptStep >= INIT_SCRIPT_LEN) {
+        port->state = PS2_STATE_DETECT;
+    }
+}
+
+static void handleReply(PS2Port_t *port, uint8_t *in) {
+    switch (port->state) {
+        case PS2_STATE_PROBE:
+            if (in != NULL) {
+                port->state = PS2_STATE_SCRIPT;
+                port->scriptStep = 0;
+                port->stepStart = millis();
             }
-        } else if (isDualShockReply(in)) {
-            uint16_t buttonWord = ~(((uint16_t)in[4] << 8) | in[3]);
-            if (bit_check(buttonWord, PSB_PAD_LEFT)) {
-                ps2ControllerType = PSX_GUITAR_HERO_CONTROLLER;
-            } else {
-                ps2ControllerType = PSX_DUALSHOCK_1_CONTROLLER;
+            break;
+        case PS2_STATE_SCRIPT: {
+            /* We can't know if we have successfully enabled analog mode until
+             * we get out of config mode, so let's just be happy if we get a
+             * valid reply
+             */
+            const PS2ScriptStep_t *step = &initScript[port->scriptStep];
+            bool ok = false;
+            if (in != NULL) {
+                if (step->expect == PS2_EXPECT_CONFIG) {
+                    ok = isConfigReply(in);
+                } else if (step->expect == PS2_EXPECT_NORMAL) {
+                    ok = !isConfigReply(in);
+                } else {
+                    ok = true;
+                }
+            }
+            if (ok) {
+                nextScriptStep(port);
+            } else if (millis() - port->stepStart > COMMAND_TIMEOUT) {
+                if (step->command == commandEnterConfig) {
+                    // Controller doesn't support config mode, skip the rest of the script
+                    port->state = PS2_STATE_DETECT;
+                } else {
+                    nextScriptStep(port);
+                }
             }
-        } else if (isFlightStickReply(in)) {
-            ps2ControllerType = PSX_FLIGHTSTICK;
-        } else if (isNegconReply(in)) {
-            ps2ControllerType = PSX_NEGCON;
-        } else if (isJogconReply(in)) {
-            ps2ControllerType = PSX_JOGCON;
-        } else if (isGunconReply(in)) {
-            ps2ControllerType = PSX_GUNCON;
-        } else if (isMouseReply(in)) {
-            ps2ControllerType = PSX_MOUSE;
-        } else if (isDigitalReply(in)) {
-            ps2ControllerType = PSX_DIGITAL;
+            break;
         }
-        initialised = true;
-        invalidCount = 0;
+        case PS2_STATE_DETECT:
+            if (in == NULL) {
+                port->state = PS2_STATE_PROBE;
+                break;
+            }
+            detectController(port, in);
+            memcpy(port->buffer, in, sizeof(port->buffer));
+            port->initialised = true;
+            port->invalidCount = 0;
+            port->state = PS2_STATE_POLL;
+            break;
+        case PS2_STATE_POLL:
+            // Ocassionally, the controller returns a bad packet because it isn't ready. We should ignore that instead of reinitialisng, and
+            // We only want to reinit if we recevied several bad packets in a row.
+            if (in != NULL) {
+                port->invalidCount = 0;
+                if (isConfigReply(in)) {
+                    // We're stuck in config mode, try to get out
+                    port->exitConfigQueued = true;
+                } else {
+                    memcpy(port->buffer, in, sizeof(port->buffer));
+                }
+            } else {
+                port->invalidCount++;
+                if (port->invalidCount > 10) {
+                    port->initialised = false;
+                    port->state = PS2_STATE_PROBE;
+                }
+            }
+            break;
     }
-    // Ocassionally, the controller returns a bad packet because it isn't ready. We should ignore that instead of reinitialisng, and
-    // We only want to reinit if we recevied several bad packets in a row.
-    if (initialised) {
-        in = autoShiftData(port, commandPollInput, sizeof(commandPollInput));
+}
 
-        if (in != NULL) {
-            invalidCount = 0;
-            if (isConfigReply(in)) {
-                // We're stuck in config mode, try to get out
-                sendCommand(port, commandExitConfig, sizeof(commandExitConfig));
+// Work out what to send to a port next, returning false if it should be skipped this sweep
+static bool nextTransfer(PS2Port_t *port, PS2Transfer_t *transfer) {
+    switch (port->state) {
+        case PS2_STATE_PROBE:
+        case PS2_STATE_DETECT:
+            transfer->command = commandPollInput;
+            transfer->len = sizeof(commandPollInput);
+            return true;
+        case PS2_STATE_SCRIPT: {
+            if (millis() - port->lastAttempt < COMMAND_RETRY_INTERVAL) {
+                return false;
             }
-            memcpy(inputBuffer2, inputBuffer, sizeof(inputBuffer));
-            last = micros();
-        } else {
-            invalidCount++;
-            if (invalidCount > 10) {
-                initialised = false;
+            port->lastAttempt = millis();
+            const PS2ScriptStep_t *step = &initScript[port->scriptStep];
+            transfer->command = step->command;
+            transfer->len = step->len;
+            return true;
+        }
+        case PS2_STATE_POLL:
+            if (port->exitConfigQueued) {
+                port->exitConfigQueued = false;
+                transfer->command = commandExitConfig;
+                transfer->len = sizeof(commandExitConfig);
+                return true;
+            }
+            // PS2 guitars die if you poll them too fast, this is tracked per port
+            // so a guitar on one port doesn't slow down the others
+            if (port->controllerType == PSX_GUITAR_HERO_CONTROLLER && micros() - port->last < 3000) {
+                return false;
+            }
+            port->last = micros();
+            transfer->command = commandPollInput;
+            transfer->len = sizeof(commandPollInput);
+            return true;
+    }
+    return false;
+}
+
+static void collectSweep(void) {
+    for (uint8_t i = 0; i < sweepCount; i++) {
+        handleReply(&ports[sweepPorts[i]], ps2TransportReply(i));
+    }
+    sweepCount = 0;
+}
+
+uint8_t *ps2PortData(uint8_t port) {
+    return ports[port].initialised ? ports[port].buffer : NULL;
+}
+
+uint8_t ps2PortControllerType(uint8_t port) {
+    return ports[port].controllerType;
+}
+
+uint8_t *tickPS2() {
+    // Every port (all four when a multitap is in use) is polled in one sweep.
+    // The sweep from the previous tick is collected, and the next one is kicked
+    // off. With the PIO engine the sweep runs in the background, otherwise it
+    // completes immediately and is collected straight away.
+    if (!ps2TransportBusy()) {
+        collectSweep();
+        PS2Transfer_t transfers[PS2_PORT_COUNT];
+        for (uint8_t i = 0; i < PS2_PORT_COUNT; i++) {
+            if (nextTransfer(&ports[i], &transfers[sweepCount])) {
+                transfers[sweepCount].port = portAddresses[i];
+                sweepPorts[sweepCount++] = i;
             }
-            in = inputBuffer2;
         }
+        if (sweepCount) {
+            ps2TransportStart(transfers, sweepCount);
+        }
+        if (!ps2TransportBusy()) {
+            collectSweep();
+        }
+    }
+    if (ports[0].initialised) {
+        ps2ControllerType = ports[0].controllerType;
     }
-    return in;
+    return ps2PortData(0);
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include <string.h>
+
+#include "defines.h"
+#include "ps2.h"
+#include "reports/ps2_reports.h"
+
+// The lower nibble of the reply id is the length of the reply body in 16 bit words
+#define PS2_REPLY_WORDS(packet) ((packet)[1] & 0x0F)
+// Buttons, sticks and then the twelve pressures
+#define PS2_STICK_WORDS 3
+#define PS2_PRESSURE_WORDS 9
+#define PS2_BUTTON(buttons, button) (((buttons) >> (button)) & 1)
+
+void ps2DecodeUsbHostData(const uint8_t *packet, uint8_t controllerType, USB_Host_Data_t *out) {
+    memset(out, 0, sizeof(USB_Host_Data_t));
+    // Buttons are active low
+    uint16_t buttons = ~(packet[3] | (packet[4] << 8));
+    out->back = PS2_BUTTON(buttons, PSB_SELECT);
+    out->leftThumbClick = PS2_BUTTON(buttons, PSB_L3);
+    out->rightThumbClick = PS2_BUTTON(buttons, PSB_R3);
+    out->start = PS2_BUTTON(buttons, PSB_START);
+    out->dpadUp = PS2_BUTTON(buttons, PSB_PAD_UP);
+    out->dpadRight = PS2_BUTTON(buttons, PSB_PAD_RIGHT);
+    out->dpadDown = PS2_BUTTON(buttons, PSB_PAD_DOWN);
+    out->dpadLeft = PS2_BUTTON(buttons, PSB_PAD_LEFT);
+    out->leftShoulder = PS2_BUTTON(buttons, PSB_L1);
+    out->rightShoulder = PS2_BUTTON(buttons, PSB_R1);
+    out->y = PS2_BUTTON(buttons, PSB_TRIANGLE);
+    out->b = PS2_BUTTON(buttons, PSB_CIRCLE);
+    out->a = PS2_BUTTON(buttons, PSB_CROSS);
+    out->x = PS2_BUTTON(buttons, PSB_SQUARE);
+    if (PS2_BUTTON(buttons, PSB_L2)) {
+        out->leftTrigger = UINT16_MAX;
+    }
+    if (PS2_BUTTON(buttons, PSB_R2)) {
+        out->rightTrigger = UINT16_MAX;
+    }
+    if (controllerType == PSX_GUITAR_HERO_CONTROLLER) {
+        out->green = PS2_BUTTON(buttons, PSB_R2);
+        out->red = PS2_BUTTON(buttons, PSB_CIRCLE);
+        out->yellow = PS2_BUTTON(buttons, PSB_TRIANGLE);
+        out->blue = PS2_BUTTON(buttons, PSB_CROSS);
+        out->orange = PS2_BUTTON(buttons, PSB_SQUARE);
+    }
+    if (PS2_REPLY_WORDS(packet) >= PS2_STICK_WORDS) {
+        if (packet[5] != PS3_STICK_CENTER) {
+            out->rightStickX = (packet[5] - PS3_STICK_CENTER) << 8;
+        }
+        if (packet[6] != PS3_STICK_CENTER) {
+            out->rightStickY = ((UINT8_MAX - packet[6]) - PS3_STICK_CENTER) << 8;
+        }
+        if (packet[7] != PS3_STICK_CENTER) {
+            out->leftStickX = (packet[7] - PS3_STICK_CENTER) << 8;
+        }
+        if (packet[8] != PS3_STICK_CENTER) {
+            out->leftStickY = ((UINT8_MAX - packet[8]) - PS3_STICK_CENTER) << 8;
+        }
+    }
+    if (PS2_REPLY_WORDS(packet) >= PS2_PRESSURE_WORDS) {
+        out->pressureDpadRight = packet[9];
+        out->pressureDpadLeft = packet[10];
+        out->pressureDpadUp = packet[11];
+        out->pressureDpadDown = packet[12];
+        out->pressureTriangle = packet[13];
+        out->pressureCircle = packet[14];
+        out->pressureCross = packet[15];
+        out->pressureSquare = packet[16];
+        out->pressureL1 = packet[17];
+        out->pressureR1 = packet[18];
+        if (packet[19]) {
+            out->leftTrigger = packet[19] << 8;
+        }
+        if (packet[20]) {
+            out->rightTrigger = packet[20] << 8;
+        }
+    }
+}
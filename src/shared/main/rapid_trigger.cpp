@@ -0,0 +1,34 @@
+#include "rapid_trigger.h"
+
+#include "config.h"
+#ifdef RAPID_TRIGGER_COUNT
+Rapid_Trigger_t rapidTriggers[RAPID_TRIGGER_COUNT];
+
+bool rapidTrigger(uint8_t index, uint16_t travel, uint16_t actuation, uint16_t pressDelta, uint16_t releaseDelta) {
+    Rapid_Trigger_t *trigger = &rapidTriggers[index];
+    if (travel < actuation) {
+        trigger->pressed = false;
+        trigger->extreme = travel;
+        return false;
+    }
+    if (trigger->pressed) {
+        // Track the deepest point, and release once the key has come back up far enough
+        if (travel > trigger->extreme) {
+            trigger->extreme = travel;
+        } else if ((uint32_t)travel + releaseDelta <= trigger->extreme) {
+            trigger->pressed = false;
+            trigger->extreme = travel;
+        }
+    } else {
+        // Track the highest point, and press once the key has gone down far enough.
+        // Coming from rest, crossing the actuation point is enough.
+        if (trigger->extreme < actuation || (uint32_t)trigger->extreme + pressDelta <= travel) {
+            trigger->pressed = true;
+            trigger->extreme = travel;
+        } else if (travel < trigger->extreme) {
+            trigger->extreme = travel;
+        }
+    }
+    return trigger->pressed;
+}
+#endif
@@ -5,17 +5,22 @@
 #include "bt.h"
 #include "config.h"
 #include "controllers.h"
+#include "drum_trigger.h"
 #include "endpoints.h"
 #include "fxpt_math.h"
 #include "hid.h"
 #include "inputs/slave.h"
 #include "io.h"
 #include "io_define.h"
+#include "log.h"
 #include "max170x.h"
 #include "mpr121.h"
 #include "pico_slave.h"
 #include "pin_funcs.h"
+#include "rapid_trigger.h"
+#include "turntable_smoothing.h"
 #include "ps2.h"
+#include "usb_host_merge.h"
 #include "usbhid.h"
 #include "util.h"
 #include "wii.h"
@@ -53,18 +58,18 @@ struct {
 Midi_Data_t midiData = {0};
 void onNote(uint8_t channel, uint8_t note, uint8_t velocity) {
     // velocities are 7 bit
-    printf("Note ON ch=%d, note=%d, vel=%d\r\n", channel, note, velocity);
+    LOG_DEBUG("Note ON ch=%d, note=%d, vel=%d", channel, note, velocity);
     midiData.midiVelocities[note] = velocity << 1;
 }
 
 void offNote(uint8_t channel, uint8_t note, uint8_t velocity) {
-    printf("Note OFF ch=%d, note=%d, vel=%d\r\n", channel, note, velocity);
+    LOG_DEBUG("Note OFF ch=%d, note=%d, vel=%d", channel, note, velocity);
     midiData.midiVelocities[note] = 0;
 }
 
 void onControlChange(uint8_t channel, uint8_t b1, uint8_t b2) {
     // cc are 7 bit
-    printf("ControlChange ch=%d, b1=%d, b2=%d\r\n", channel, b1, b2);
+    LOG_DEBUG("ControlChange ch=%d, b1=%d, b2=%d", channel, b1, b2);
     if (b1 == MIDI_CONTROL_COMMAND_SUSTAIN_PEDAL) {
         midiData.midiSustainPedal = b2 << 1;
     }
@@ -75,7 +80,7 @@ void onControlChange(uint8_t channel, uint8_t b1, uint8_t b2) {
 
 void onPitchBend(uint8_t channel, int pitch) {
     // pitchbend is signed 14 bit
-    printf("PitchBend ch=%d, pitch=%d\r\n", channel, pitch);
+    LOG_DEBUG("PitchBend ch=%d, pitch=%d", channel, pitch);
     midiData.midiPitchWheel = pitch << 2;
 }
 #endif
@@ -91,15 +96,6 @@ uint8_t queue_size = 0;
 uint8_t led_tmp;
 uint8_t queue_tail = 0;
 Buffer_Report_t queue[BUFFER_SIZE_QUEUE];
-#define TURNTABLE_BUFFER_SIZE 16
-#ifdef INPUT_DJ_TURNTABLE_SMOOTHING
-int16_t dj_sum_left = 0;
-int8_t dj_last_readings_left[TURNTABLE_BUFFER_SIZE];
-int8_t dj_next_left = 0;
-int16_t dj_sum_right = 0;
-int8_t dj_last_readings_right[TURNTABLE_BUFFER_SIZE];
-int8_t dj_next_right = 0;
-#endif
 USB_Report_Data_t combined_report;
 #if DEVICE_TYPE_IS_NORMAL_GAMEPAD
 PS3_REPORT bt_report;
@@ -110,6 +106,54 @@ uint8_t debounce[DIGITAL_COUNT];
 uint8_t ledDebounce[LED_DEBOUNCE_COUNT];
 uint16_t lastDrum[DIGITAL_COUNT];
 uint8_t drumVelocity[8];
+#if SUPPORTS_MIDI
+// Pro keys start at C3 on channel 1, and drums use the general MIDI percussion map on channel 10
+#define MIDI_KEYS_FIRST_NOTE 48
+#define MIDI_KEYS_CHANNEL 0
+#define MIDI_DRUMS_CHANNEL 9
+#define MIDI_CIN_NOTE_ON 0x09
+#define MIDI_CIN_CONTROL_CHANGE 0x0B
+// Indexed by DrumType
+const uint8_t midiDrumNotes[] = {45, 38, 42, 48, 49, 36, 44};
+const uint8_t midiControls[] = {MIDI_CONTROL_COMMAND_MOD_WHEEL, MIDI_CONTROL_COMMAND_SUSTAIN_PEDAL};
+// Mod wheel and sustain, filled from the pro keys touch strip and pedal each tick
+uint8_t midiControlValues[sizeof(midiControls)];
+// What the host was last told. Only the differences to this are sent.
+uint8_t lastMidiKeys[25];
+uint8_t lastMidiDrums[sizeof(midiDrumNotes)];
+uint8_t lastMidiControls[sizeof(midiControls)];
+// Releases are sent as a note on with zero velocity
+static bool addMidiNote(USB_MIDI_Data_t *report, uint8_t *count, uint8_t channel, uint8_t note, uint8_t velocity, uint8_t *last) {
+    if ((velocity != 0) == (*last != 0)) {
+        return true;
+    }
+    if (*count >= SIMULTANEOUS_MIDI) {
+        return false;
+    }
+    MIDI_EVENT_PACKET *packet = &report->midi[(*count)++];
+    packet->Event = MIDI_CIN_NOTE_ON;
+    packet->Data1 = 0x90 | channel;
+    packet->Data2 = note;
+    packet->Data3 = velocity;
+    *last = velocity;
+    return true;
+}
+static bool addMidiControl(USB_MIDI_Data_t *report, uint8_t *count, uint8_t channel, uint8_t control, uint8_t value, uint8_t *last) {
+    if (value == *last) {
+        return true;
+    }
+    if (*count >= SIMULTANEOUS_MIDI) {
+        return false;
+    }
+    MIDI_EVENT_PACKET *packet = &report->midi[(*count)++];
+    packet->Event = MIDI_CIN_CONTROL_CHANGE;
+    packet->Data1 = 0xB0 | channel;
+    packet->Data2 = control;
+    packet->Data3 = value;
+    *last = value;
+    return true;
+}
+#endif
 bool tiltActive = false;
 long lastTilt = 0;
 long lastDj = 0;
@@ -124,6 +168,10 @@ uint8_t ghl_sequence_number_host = 1;
 uint16_t wiiControllerType = WII_NO_EXTENSION;
 uint8_t ps2ControllerType = PSX_NO_DEVICE;
 uint8_t lastSuccessfulPS2Packet[BUFFER_SIZE];
+#ifdef INPUT_PS2_MULTITAP
+uint8_t lastSuccessfulPS2MultitapPackets[PS2_PORT_COUNT][BUFFER_SIZE];
+uint8_t lastPS2MultitapSuccessful = 0;
+#endif
 uint8_t lastSuccessfulWiiPacket[8];
 uint8_t lastSuccessfulGH5Packet[2];
 uint8_t lastSuccessfulClonePacket[4];
@@ -254,11 +302,12 @@ void init_main(void) {
     memset(ledStatePeripheral, 0, sizeof(ledStatePeripheral));
     LED_INIT;
 #ifdef INPUT_DJ_TURNTABLE_SMOOTHING
-    memset(dj_last_readings_left, 0, sizeof(dj_last_readings_left));
-    memset(dj_last_readings_right, 0, sizeof(dj_last_readings_right));
+    memset(&dj_smoothing_left, 0, sizeof(dj_smoothing_left));
+    memset(&dj_smoothing_right, 0, sizeof(dj_smoothing_right));
 #endif
 #ifdef INPUT_PS2
     init_ack();
+    ps2TransportInit();
 #endif
 #ifdef TICK_PS2
     ps2_emu_init();
@@ -297,6 +346,9 @@ void tick_slave() {
 #ifdef INPUT_WT_SLAVE_NECK
     slaveInitWt();
 #endif
+#ifdef SLAVE_INTERRUPT
+    slaveInitInterrupt();
+#endif
 }
 #endif
 int16_t adc_i(uint8_t pin) {
@@ -1540,6 +1592,7 @@ void tick_ps2output() {
 // Tick Inputs
 #include "inputs/adxl.h"
 #include "inputs/clone_neck.h"
+#include "inputs/drum_trigger.h"
 #include "inputs/gh5_neck.h"
 #include "inputs/mpr121.h"
 #include "inputs/ps2.h"
@@ -1562,6 +1615,7 @@ void tick_ps2output() {
 void tick_wiioutput() {
 #include "inputs/adxl.h"
 #include "inputs/clone_neck.h"
+#include "inputs/drum_trigger.h"
 #include "inputs/gh5_neck.h"
 #include "inputs/mpr121.h"
 #include "inputs/ps2.h"
@@ -1661,6 +1715,7 @@ uint8_t tick_inputs(void *buf, USB_LastReport_Data_t *last_report, uint8_t outpu
 // Tick Inputs
 #include "inputs/adxl.h"
 #include "inputs/clone_neck.h"
+#include "inputs/drum_trigger.h"
 #include "inputs/gh5_neck.h"
 #include "inputs/mpr121.h"
 #include "inputs/ps2.h"
@@ -1893,6 +1948,57 @@ uint8_t tick_inputs(void *buf, USB_LastReport_Data_t *last_report, uint8_t outpu
 #endif
         report_size = packet_size = sizeof(XINPUT_REPORT);
     }
+#if SUPPORTS_MIDI
+    if (output_console_type == MIDI_ID) {
+        {
+            // The PS3 tick already works out key and pad velocities and the pedal and touch strip,
+            // so run it into a scratch report and turn what it wrote into MIDI
+            PS3_REPORT scratch;
+            PS3_REPORT *report = &scratch;
+            PS3Dpad_Data_t *gamepad = (PS3Dpad_Data_t *)report;
+            memset(report, 0, sizeof(PS3_REPORT));
+            TICK_PS3;
+            asm volatile("" ::
+                             : "memory");
+#if DEVICE_TYPE == ROCK_BAND_PRO_KEYS
+            midiControlValues[0] = report->touchPad << 1;
+            midiControlValues[1] = report->pedalDigital ? UINT8_MAX : report->pedalAnalog << 1;
+#elif DEVICE_TYPE == GUITAR_HERO_DRUMS
+            drumVelocity[DRUM_GREEN] = report->greenVelocity;
+            drumVelocity[DRUM_RED] = report->redVelocity;
+            drumVelocity[DRUM_YELLOW] = report->yellowVelocity;
+            drumVelocity[DRUM_BLUE] = report->blueVelocity;
+            drumVelocity[DRUM_ORANGE] = report->orangeVelocity;
+            drumVelocity[DRUM_KICK] = report->kickVelocity;
+#elif DEVICE_TYPE == ROCK_BAND_DRUMS
+            // Cymbals share their pad's velocity. Yellow plays the hi-hat and green the crash, blue stays a tom.
+            drumVelocity[DRUM_GREEN] = report->greenVelocity;
+            drumVelocity[DRUM_RED] = report->redVelocity;
+            drumVelocity[DRUM_YELLOW] = report->yellowVelocity;
+            drumVelocity[DRUM_BLUE] = report->blueVelocity > report->blueCymbalVelocity ? report->blueVelocity : report->blueCymbalVelocity;
+            drumVelocity[DRUM_HIHAT] = report->yellowCymbalVelocity;
+            drumVelocity[DRUM_ORANGE] = report->greenCymbalVelocity;
+            // There is no kick velocity, so either pedal hits at full velocity
+            drumVelocity[DRUM_KICK] = (report->leftShoulder || report->rightShoulder) ? UINT8_MAX : 0;
+#endif
+            (void)gamepad;
+        }
+        USB_MIDI_Data_t *report = (USB_MIDI_Data_t *)report_data;
+        // Pack every change since the last transfer into one, anything that doesn't fit goes out next time
+        uint8_t count = 0;
+        bool space = true;
+        for (uint8_t i = 0; i < sizeof(lastMidiKeys) && space; i++) {
+            space = addMidiNote(report, &count, MIDI_KEYS_CHANNEL, MIDI_KEYS_FIRST_NOTE + i, proKeyVelocities[i] >> 1, &lastMidiKeys[i]);
+        }
+        for (uint8_t i = 0; i < sizeof(lastMidiDrums) && space; i++) {
+            space = addMidiNote(report, &count, MIDI_DRUMS_CHANNEL, midiDrumNotes[i], drumVelocity[i] >> 1, &lastMidiDrums[i]);
+        }
+        for (uint8_t i = 0; i < sizeof(lastMidiControls) && space; i++) {
+            space = addMidiControl(report, &count, MIDI_KEYS_CHANNEL, midiControls[i], midiControlValues[i] >> 1, &lastMidiControls[i]);
+        }
+        report_size = packet_size = count * sizeof(MIDI_EVENT_PACKET);
+    }
+#endif
 // Guitars and Drums can fall back to their PS3 versions, so don't even include the PS4 version there.
 // DJ Hero was never on ps4, so we can't really implement that either, so just fall back to PS3 there too.
 #if SUPPORTS_PS4
@@ -1982,10 +2088,10 @@ uint8_t tick_inputs(void *buf, USB_LastReport_Data_t *last_report, uint8_t outpu
         TICK_PS3_WITHOUT_CAPTURE;
         report_size = packet_size = sizeof(PS3Gamepad_Data_t);
     }
-    if (output_console_type != WINDOWS && output_console_type != XBOX360 && output_console_type != PS3 && output_console_type != BLUETOOTH_REPORT && output_console_type != UNIVERSAL && output_console_type != XBOXONE && output_console_type != PS4) {
+    if (output_console_type != WINDOWS && output_console_type != XBOX360 && output_console_type != PS3 && output_console_type != BLUETOOTH_REPORT && output_console_type != UNIVERSAL && output_console_type != XBOXONE && output_console_type != PS4 && output_console_type != MIDI_ID) {
 #else
     // For instruments, we instead use the below block, as all other console types use the below format
-    if ((output_console_type != WINDOWS && output_console_type != KEYBOARD_MOUSE && output_console_type != FNF && output_console_type != XBOX360 && output_console_type != PS4 && output_console_type != BLUETOOTH_REPORT && output_console_type != UNIVERSAL && output_console_type != XBOXONE) || updateHIDSequence) {
+    if ((output_console_type != WINDOWS && output_console_type != KEYBOARD_MOUSE && output_console_type != FNF && output_console_type != XBOX360 && output_console_type != PS4 && output_console_type != BLUETOOTH_REPORT && output_console_type != UNIVERSAL && output_console_type != XBOXONE && output_console_type != MIDI_ID) || updateHIDSequence) {
 #endif
         report_size = sizeof(PS3_REPORT);
         // Do NOT update the size for XBONE, since the XBONE packets have a totally different size!
@@ -2191,6 +2297,7 @@ int tick_bluetooth_inputs(const void *buf) {
     uint8_t output_console_type = consoleType;
     // Tick Inputs
 #include "inputs/clone_neck.h"
+#include "inputs/drum_trigger.h"
 #include "inputs/gh5_neck.h"
 #include "inputs/ps2.h"
 #include "inputs/slave_tick.h"
@@ -2503,6 +2610,7 @@ void tick(void) {
         if (memcmp(lastLedStatePeripheral, ledStatePeripheral, sizeof(ledStatePeripheral)) != 0) {
             memcpy(lastLedStatePeripheral, ledStatePeripheral, sizeof(ledStatePeripheral));
             TICK_LED_PERIPHERAL;
+            slaveFlushLED();
         }
     } else {
         memset(lastLedStatePeripheral, 0, sizeof(lastLedStatePeripheral));
@@ -2623,12 +2731,15 @@ void xinput_controller_connected(uint16_t vid, uint16_t pid) {
     xbox_360_pid = pid;
 }
 
-void xinput_w_controller_connected() {
-    handle_player_leds(0);
+void xinput_w_controller_connected(uint8_t dev_addr, uint8_t instance) {
+    // Controllers link to the receiver long after it was mounted, so they missed the last player led update
+#ifdef INPUT_USB_HOST
+    handle_player_leds_xinput_w(dev_addr, instance);
+#endif
 }
 
 void xone_controller_connected(uint8_t dev_addr, uint8_t instance) {
-    printf("Sending to controller %d\r\n", dev_addr);
+    LOG_DEBUG("Sending to controller %d", dev_addr);
     send_report_to_controller(dev_addr, instance, (uint8_t *)&powerMode, sizeof(GipPowerMode_t));
 }
 bool xone_controller_send_init_packet(uint8_t dev_addr, uint8_t instance, uint8_t id) {
@@ -2662,7 +2773,7 @@ void ps3_controller_connected(uint8_t dev_addr, uint16_t vid, uint16_t pid) {
     if (vid == SONY_VID && pid == SONY_DS3_PID) {
         // Enable PS3 reports
         uint8_t hid_command_enable[] = {0x42, 0x0c, 0x00, 0x00};
-        transfer_with_usb_controller(dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x03F4, 0x00, sizeof(hid_command_enable), hid_command_enable);
+        queue_transfer_with_usb_controller(dev_addr, (USB_SETUP_HOST_TO_DEVICE | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_CLASS), HID_REQUEST_SET_REPORT, 0x03F4, 0x00, sizeof(hid_command_enable), hid_command_enable);
         handle_player_leds(0);
     }
 }
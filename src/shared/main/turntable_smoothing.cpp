@@ -0,0 +1,24 @@
+#include "turntable_smoothing.h"
+
+#include "config.h"
+#ifdef INPUT_DJ_TURNTABLE_SMOOTHING
+Turntable_Smoothing_t dj_smoothing_left;
+Turntable_Smoothing_t dj_smoothing_right;
+
+void smoothTurntable(Turntable_Smoothing_t *smoothing, int8_t reading) {
+    int32_t sample = (int32_t)reading << 8;
+    int32_t delta = sample - smoothing->last;
+    smoothing->last = sample;
+    smoothing->derivative += (delta - smoothing->derivative) >> TURNTABLE_SMOOTHING_DERIVATIVE_SHIFT;
+    uint32_t speed = (smoothing->derivative < 0 ? -smoothing->derivative : smoothing->derivative) >> 8;
+    uint32_t alpha = TURNTABLE_SMOOTHING_MIN_ALPHA + speed * TURNTABLE_SMOOTHING_BETA;
+    if (alpha > 256) {
+        alpha = 256;
+    }
+    smoothing->value += ((sample - smoothing->value) * (int32_t)alpha) >> 8;
+}
+
+int8_t smoothedTurntable(Turntable_Smoothing_t *smoothing) {
+    return (smoothing->value + 0x80) >> 8;
+}
+#endif
@@ -0,0 +1,99 @@
+#include "usb_host_merge.h"
+
+#include <stddef.h>
+#include <string.h>
+
+typedef struct {
+    uint8_t offset;
+    uint8_t size;
+    uint16_t rest;
+} Usb_Host_Value_t;
+#define USB_HOST_VALUE(field, rest) {offsetof(USB_Host_Data_t, field), sizeof(((USB_Host_Data_t *)0)->field), rest}
+static const Usb_Host_Value_t usb_host_values[] = {
+    USB_HOST_VALUE(leftTrigger, 0),
+    USB_HOST_VALUE(rightTrigger, 0),
+    USB_HOST_VALUE(leftStickX, 0),
+    USB_HOST_VALUE(leftStickY, 0),
+    USB_HOST_VALUE(rightStickX, 0),
+    USB_HOST_VALUE(rightStickY, 0),
+    USB_HOST_VALUE(pressureDpadUp, 0),
+    USB_HOST_VALUE(pressureDpadRight, 0),
+    USB_HOST_VALUE(pressureDpadLeft, 0),
+    USB_HOST_VALUE(pressureDpadDown, 0),
+    USB_HOST_VALUE(pressureL1, 0),
+    USB_HOST_VALUE(pressureR1, 0),
+    USB_HOST_VALUE(pressureTriangle, 0),
+    USB_HOST_VALUE(pressureCircle, 0),
+    USB_HOST_VALUE(pressureCross, 0),
+    USB_HOST_VALUE(pressureSquare, 0),
+    USB_HOST_VALUE(redVelocity, 0),
+    USB_HOST_VALUE(yellowVelocity, 0),
+    USB_HOST_VALUE(blueVelocity, 0),
+    USB_HOST_VALUE(greenVelocity, 0),
+    USB_HOST_VALUE(orangeVelocity, 0),
+    USB_HOST_VALUE(blueCymbalVelocity, 0),
+    USB_HOST_VALUE(yellowCymbalVelocity, 0),
+    USB_HOST_VALUE(greenCymbalVelocity, 0),
+    USB_HOST_VALUE(kickVelocity, 0),
+    USB_HOST_VALUE(whammy, 0),
+    USB_HOST_VALUE(pickup, 0),
+    USB_HOST_VALUE(tilt, 0),
+    USB_HOST_VALUE(slider, 0x80),
+    USB_HOST_VALUE(leftTableVelocity, 0),
+    USB_HOST_VALUE(rightTableVelocity, 0),
+    USB_HOST_VALUE(effectsKnob, 0),
+    USB_HOST_VALUE(crossfader, 0),
+    USB_HOST_VALUE(accelX, PS3_ACCEL_CENTER),
+    USB_HOST_VALUE(accelZ, PS3_ACCEL_CENTER),
+    USB_HOST_VALUE(accelY, PS3_ACCEL_CENTER),
+    USB_HOST_VALUE(gyro, PS3_ACCEL_CENTER),
+    // Generic axes are unsigned, so centered sticks rest in the middle
+    USB_HOST_VALUE(genericAxisX, 0x8000),
+    USB_HOST_VALUE(genericAxisY, 0x8000),
+    USB_HOST_VALUE(genericAxisZ, 0x8000),
+    USB_HOST_VALUE(genericAxisRx, 0x8000),
+    USB_HOST_VALUE(genericAxisRy, 0x8000),
+    USB_HOST_VALUE(genericAxisRz, 0x8000),
+    USB_HOST_VALUE(genericAxisSlider, 0),
+    USB_HOST_VALUE(mouse.x, 0),
+    USB_HOST_VALUE(mouse.y, 0),
+    USB_HOST_VALUE(mouse.scrollY, 0),
+    USB_HOST_VALUE(mouse.scrollX, 0),
+};
+
+static inline uint16_t read_value(const uint8_t *data, const Usb_Host_Value_t *value) {
+    uint16_t current = data[value->offset];
+    if (value->size == 2) {
+        current |= data[value->offset + 1] << 8;
+    }
+    return current;
+}
+
+void reset_usb_host_data(USB_Host_Data_t *out) {
+    memset(out, 0, sizeof(USB_Host_Data_t));
+    uint8_t *dest = (uint8_t *)out;
+    for (uint8_t i = 0; i < sizeof(usb_host_values) / sizeof(usb_host_values[0]); i++) {
+        const Usb_Host_Value_t *value = &usb_host_values[i];
+        memcpy(dest + value->offset, &value->rest, value->size);
+    }
+}
+
+void merge_usb_host_data(USB_Host_Data_t *out, const USB_Host_Data_t *in) {
+    const uint8_t *src = (const uint8_t *)in;
+    uint8_t *dest = (uint8_t *)out;
+    for (uint8_t i = 0; i < offsetof(USB_Host_Data_t, leftTrigger); i++) {
+        dest[i] |= src[i];
+    }
+    out->genericButtons |= in->genericButtons;
+    for (uint8_t i = 0; i < sizeof(USB_NKRO_Data_t); i++) {
+        dest[offsetof(USB_Host_Data_t, keyboard) + i] |= src[offsetof(USB_Host_Data_t, keyboard) + i];
+    }
+    dest[offsetof(USB_Host_Data_t, mouse)] |= src[offsetof(USB_Host_Data_t, mouse)];
+    for (uint8_t i = 0; i < sizeof(usb_host_values) / sizeof(usb_host_values[0]); i++) {
+        const Usb_Host_Value_t *value = &usb_host_values[i];
+        uint16_t current = read_value(src, value);
+        if (current != value->rest && current != 0) {
+            memcpy(dest + value->offset, src + value->offset, value->size);
+        }
+    }
+}
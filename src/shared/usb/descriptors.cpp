@@ -600,6 +600,14 @@ AuthPageSizeReport ps4_pagesize_report = {
 
 uint8_t idle_rate;
 uint8_t protocol_mode = HID_RPT_PROTOCOL;
+#if USB_HOST_PASSTHROUGH
+static const uint8_t usb_host_passthrough_subtypes[] = USB_HOST_PASSTHROUGH_SUBTYPES;
+static_assert(sizeof(usb_host_passthrough_subtypes) >= USB_HOST_PASSTHROUGH, "USB_HOST_PASSTHROUGH_SUBTYPES needs a subtype for every passthrough slot");
+#endif
+// Passthrough interfaces answer the same xinput requests as the main interface
+static bool is_xinput_interface(uint16_t wIndex) {
+    return wIndex == INTERFACE_ID_Device || (wIndex >= INTERFACE_ID_Passthrough && wIndex < INTERFACE_ID_Passthrough + USB_HOST_PASSTHROUGH_SLOTS);
+}
 bool controlRequestValid(const uint8_t requestType, const uint8_t request, const uint16_t wValue, const uint16_t wIndex, const uint16_t wLength) {
     // printf("%02x %04x %04x %04x %04x\r\n", requestType, request, wValue, wIndex, wLength);
     if (consoleType == UNIVERSAL && requestType == (USB_SETUP_DEVICE_TO_HOST | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_VENDOR) && request == 0x81) {
@@ -672,11 +680,11 @@ bool controlRequestValid(const uint8_t requestType, const uint8_t request, const
             return true;
         }
     } else if (requestType == (USB_SETUP_DEVICE_TO_HOST | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_VENDOR)) {
-        if (request == HID_REQUEST_GET_REPORT && wIndex == INTERFACE_ID_Device && wValue == VIBRATION_CAPABILITIES_WVALUE) {
+        if (request == HID_REQUEST_GET_REPORT && is_xinput_interface(wIndex) && wValue == VIBRATION_CAPABILITIES_WVALUE) {
             return true;
         } else if (request == REQ_GET_OS_FEATURE_DESCRIPTOR && wIndex == DESC_EXTENDED_PROPERTIES_DESCRIPTOR && wValue == INTERFACE_ID_Config) {
             return true;
-        } else if (request == HID_REQUEST_GET_REPORT && wIndex == INTERFACE_ID_Device && wValue == INPUT_CAPABILITIES_WVALUE) {
+        } else if (request == HID_REQUEST_GET_REPORT && is_xinput_interface(wIndex) && wValue == INPUT_CAPABILITIES_WVALUE) {
             return true;
         }
     } else if (requestType == (USB_SETUP_DEVICE_TO_HOST | USB_SETUP_RECIPIENT_DEVICE | USB_SETUP_TYPE_VENDOR) && (consoleType == WINDOWS || consoleType == XBOX360) && request == HID_REQUEST_GET_REPORT && wIndex == 0x0000 && wValue == SERIAL_NUMBER_WVALUE) {
@@ -934,13 +942,13 @@ uint16_t controlRequest(const uint8_t requestType, const uint8_t request, const
         printf("Master bd address set\r\n");
         return 1;
     } else if (requestType == (USB_SETUP_DEVICE_TO_HOST | USB_SETUP_RECIPIENT_INTERFACE | USB_SETUP_TYPE_VENDOR)) {
-        if (request == HID_REQUEST_GET_REPORT && wIndex == INTERFACE_ID_Device && wValue == VIBRATION_CAPABILITIES_WVALUE) {
+        if (request == HID_REQUEST_GET_REPORT && is_xinput_interface(wIndex) && wValue == VIBRATION_CAPABILITIES_WVALUE) {
             memcpy_P(requestBuffer, &XInputVibrationCapabilities, sizeof(XInputVibrationCapabilities));
             return sizeof(XInputVibrationCapabilities);
         } else if (request == REQ_GET_OS_FEATURE_DESCRIPTOR && wIndex == DESC_EXTENDED_PROPERTIES_DESCRIPTOR) {
             memcpy_P(requestBuffer, &ExtendedIDs, ExtendedIDs.TotalLength);
             return ExtendedIDs.TotalLength;
-        } else if (request == HID_REQUEST_GET_REPORT && wIndex == INTERFACE_ID_Device && wValue == INPUT_CAPABILITIES_WVALUE) {
+        } else if (request == HID_REQUEST_GET_REPORT && is_xinput_interface(wIndex) && wValue == INPUT_CAPABILITIES_WVALUE) {
             memcpy_P(requestBuffer, &XInputInputCapabilities, sizeof(XInputInputCapabilities));
             return sizeof(XInputInputCapabilities);
         }
@@ -961,7 +969,17 @@ uint16_t controlRequest(const uint8_t requestType, const uint8_t request, const
             OS_COMPATIBLE_ID_DESCRIPTOR *compat = (OS_COMPATIBLE_ID_DESCRIPTOR *)requestBuffer;
             compat->TotalSections = 2;
             compat->TotalLength = sizeof(OS_COMPATIBLE_ID_DESCRIPTOR);
-            return sizeof(OS_COMPATIBLE_ID_DESCRIPTOR);
+#if USB_HOST_PASSTHROUGH
+            // Passthrough interfaces bind to the xinput driver, just like the main one
+            OS_COMPATIBLE_SECTION *section = (OS_COMPATIBLE_SECTION *)(requestBuffer + sizeof(OS_COMPATIBLE_ID_DESCRIPTOR));
+            for (uint8_t i = 0; i < USB_HOST_PASSTHROUGH_SLOTS; i++, section++) {
+                memcpy(section, &compat->CompatID[1], sizeof(OS_COMPATIBLE_SECTION));
+                section->FirstInterfaceNumber = INTERFACE_ID_Passthrough + i;
+                compat->TotalSections++;
+                compat->TotalLength += sizeof(OS_COMPATIBLE_SECTION);
+            }
+#endif
+            return compat->TotalLength;
         } else if (consoleType == PS3 || consoleType == WII_RB) {
             memcpy_P(requestBuffer, &DevCompatIDsPS3, sizeof(OS_COMPATIBLE_ID_DESCRIPTOR_SINGLE));
         } else if (consoleType != UNIVERSAL) {
@@ -1123,6 +1141,23 @@ uint16_t descriptorRequest(const uint16_t wValue,
                 if (consoleType == WINDOWS || consoleType == XBOX360) {
                 size = sizeof(XBOX_360_CONFIGURATION_DESCRIPTOR);
                 memcpy_P(descriptorBuffer, &XBOX360ConfigurationDescriptor, size);
+#if USB_HOST_PASSTHROUGH
+                if (consoleType == WINDOWS) {
+                    // Each passthrough interface is a copy of the gamepad interface, with its own endpoints
+                    XBOX_360_CONFIGURATION_DESCRIPTOR *desc = (XBOX_360_CONFIGURATION_DESCRIPTOR *)descriptorBuffer;
+                    XBOX_360_PASSTHROUGH_DESCRIPTOR *passthrough = (XBOX_360_PASSTHROUGH_DESCRIPTOR *)((uint8_t *)descriptorBuffer + size);
+                    for (uint8_t i = 0; i < USB_HOST_PASSTHROUGH; i++, passthrough++) {
+                        memcpy(passthrough, &desc->InterfaceGamepad, sizeof(XBOX_360_PASSTHROUGH_DESCRIPTOR));
+                        passthrough->InterfaceGamepad.bInterfaceNumber = INTERFACE_ID_Passthrough + i;
+                        passthrough->GamepadDescriptor.subtype = usb_host_passthrough_subtypes[i];
+                        passthrough->GamepadDescriptor.bEndpointAddressIn = passthrough->ReportINEndpoint.bEndpointAddress = XINPUT_PASSTHROUGH_IN + i;
+                        passthrough->GamepadDescriptor.bEndpointAddressOut = passthrough->ReportOUTEndpoint.bEndpointAddress = XINPUT_PASSTHROUGH_OUT + i;
+                    }
+                    size += USB_HOST_PASSTHROUGH * sizeof(XBOX_360_PASSTHROUGH_DESCRIPTOR);
+                    desc->Config.bNumInterfaces += USB_HOST_PASSTHROUGH;
+                    desc->Config.wTotalLength = size;
+                }
+#endif
             } else if (consoleType == OG_XBOX) {
                 size = sizeof(OG_XBOX_CONFIGURATION_DESCRIPTOR);
                 memcpy_P(descriptorBuffer, &OGXBOXConfigurationDescriptor, size);
@@ -0,0 +1,15 @@
+#pragma once
+// Config used by the native unit tests, standing in for the one generated by the config tool
+#define DEVICE_TYPE GUITAR_HERO_GUITAR
+#define EMULATION_TYPE EMULATION_TYPE_CONTROLLER
+#define CONFIGURATION_LEN 1
+#define LED_COUNT 1
+#define LED_COUNT_PERIPHERAL 1
+#define RAPID_TRIGGER_COUNT 4
+#define INPUT_DJ_TURNTABLE_SMOOTHING 1
+#define INPUT_DRUM_TRIGGER 1
+#define DRUM_TRIGGER_MASK 0x0F
+// Drum triggers run at the AVR rates on the host
+#define ADC_COUNT 4
+#define F_CPU 16000000UL
+#define USB_HOST_STACK 1
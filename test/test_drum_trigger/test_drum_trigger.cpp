@@ -0,0 +1,204 @@
+#include <math.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include "drum_trigger.h"
+
+// Time between two samples on the same pad
+#define SAMPLE_US (1000000.0 / DRUM_TRIGGER_RATE)
+// Piezo pads ring at around 1 kHz and die away over a few ms. The trace is rectified, as the pads are
+// biased so the ADC only sees one side of the swing.
+#define RING_HZ 1000.0
+#define DECAY_US 1500.0
+#define NOISE 256
+
+static uint32_t sampleIndex;
+
+static uint16_t piezo(uint32_t peak, double t) {
+    if (t < 0) {
+        return 0;
+    }
+    double swing = peak * exp(-t / DECAY_US) * fabs(sin(2 * M_PI * RING_HZ * t / 1000000.0));
+    return swing > UINT16_MAX ? UINT16_MAX : swing;
+}
+
+// Feeds every pad one sample, the way the ADC interrupt does, with hits starting at the given times
+static void sample(const uint32_t *peaks, const double *starts) {
+    double now = sampleIndex * SAMPLE_US;
+    for (uint8_t channel = 0; channel < DRUM_TRIGGER_CHANNELS; channel++) {
+        uint16_t value = rand() % NOISE;
+        if (peaks[channel]) {
+            uint16_t hit = piezo(peaks[channel], now - starts[channel]);
+            if (hit > value) {
+                value = hit;
+            }
+        }
+        if (drumTriggerSample(channel, value)) {
+            drumTriggerHit(channel, now);
+        }
+    }
+    sampleIndex++;
+}
+
+static void run(const uint32_t *peaks, const double *starts, uint32_t us) {
+    uint32_t end = sampleIndex + us / SAMPLE_US;
+    while (sampleIndex < end) {
+        sample(peaks, starts);
+    }
+}
+
+static void idle(uint32_t us) {
+    static const uint32_t none[DRUM_TRIGGER_CHANNELS] = {0};
+    static const double never[DRUM_TRIGGER_CHANNELS] = {0};
+    run(none, never, us);
+}
+
+// The highest point of the trace within the scan window, which is what the velocity should be
+static uint16_t expectedPeak(uint32_t peak) {
+    uint16_t highest = 0;
+    for (double t = 0; t < DRUM_TRIGGER_SCAN_US; t += 1) {
+        uint16_t value = piezo(peak, t);
+        if (value > highest) {
+            highest = value;
+        }
+    }
+    return highest;
+}
+
+void setUp(void) {
+    srand(1);
+    // Let every pad fall back to idle, and throw away anything still queued or held
+    idle(DRUM_TRIGGER_RETRIGGER_US * 2);
+    Drum_Trigger_Event_t event;
+    while (drumTriggerPop(&event)) {
+    }
+    drumTriggerTick(sampleIndex * SAMPLE_US + DRUM_TRIGGER_HOLD_US * 2);
+}
+
+void tearDown(void) {}
+
+void test_noise_is_not_a_hit(void) {
+    idle(100000);
+    Drum_Trigger_Event_t event;
+    TEST_ASSERT_FALSE(drumTriggerPop(&event));
+}
+
+void test_hit_is_timestamped_with_peak_velocity(void) {
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {40000};
+    double start = sampleIndex * SAMPLE_US + 1000;
+    double starts[DRUM_TRIGGER_CHANNELS] = {start};
+    run(peaks, starts, 20000);
+    Drum_Trigger_Event_t event;
+    TEST_ASSERT_TRUE(drumTriggerPop(&event));
+    TEST_ASSERT_EQUAL_UINT8(0, event.channel);
+    // The ADC only sees the swing every SAMPLE_US, so the peak it catches can be a little short of the real one
+    TEST_ASSERT_UINT_WITHIN(expectedPeak(40000) / 50, expectedPeak(40000), event.velocity);
+    // Reported once the scan window is over, measured from when the threshold was crossed
+    TEST_ASSERT_UINT_WITHIN(SAMPLE_US * 2, start + DRUM_TRIGGER_SCAN_US, event.time);
+    TEST_ASSERT_FALSE(drumTriggerPop(&event));
+}
+
+void test_scan_finds_late_peak(void) {
+    // A soft hit crosses the threshold on the way up, the peak comes later in the scan window
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {0, 8000};
+    double starts[DRUM_TRIGGER_CHANNELS] = {0, sampleIndex * SAMPLE_US};
+    run(peaks, starts, 20000);
+    Drum_Trigger_Event_t event;
+    TEST_ASSERT_TRUE(drumTriggerPop(&event));
+    TEST_ASSERT_EQUAL_UINT8(1, event.channel);
+    TEST_ASSERT_UINT_WITHIN(expectedPeak(8000) / 50, expectedPeak(8000), event.velocity);
+    TEST_ASSERT_TRUE(event.velocity > DRUM_TRIGGER_THRESHOLD * 2);
+}
+
+void test_ringing_is_masked(void) {
+    // The ring is still well over the threshold after the scan window, but only one hit comes out
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {0, 0, 65535};
+    double starts[DRUM_TRIGGER_CHANNELS] = {0, 0, sampleIndex * SAMPLE_US};
+    TEST_ASSERT_TRUE(piezo(65535, DRUM_TRIGGER_SCAN_US + 250) > DRUM_TRIGGER_THRESHOLD);
+    run(peaks, starts, DRUM_TRIGGER_RETRIGGER_US);
+    Drum_Trigger_Event_t event;
+    TEST_ASSERT_TRUE(drumTriggerPop(&event));
+    TEST_ASSERT_FALSE(drumTriggerPop(&event));
+}
+
+void test_hit_after_mask_is_detected(void) {
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {30000};
+    double starts[DRUM_TRIGGER_CHANNELS] = {sampleIndex * SAMPLE_US};
+    run(peaks, starts, DRUM_TRIGGER_RETRIGGER_US + DRUM_TRIGGER_SCAN_US * 2);
+    starts[0] = sampleIndex * SAMPLE_US;
+    run(peaks, starts, DRUM_TRIGGER_SCAN_US * 2);
+    Drum_Trigger_Event_t first, second;
+    TEST_ASSERT_TRUE(drumTriggerPop(&first));
+    TEST_ASSERT_TRUE(drumTriggerPop(&second));
+    TEST_ASSERT_TRUE(second.time - first.time > DRUM_TRIGGER_RETRIGGER_US);
+}
+
+void test_crosstalk_is_dropped(void) {
+    // Pad 0 is hit, and a quarter of it bleeds into pad 1 a moment later
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {60000, 15000};
+    double start = sampleIndex * SAMPLE_US;
+    double starts[DRUM_TRIGGER_CHANNELS] = {start, start + SAMPLE_US};
+    run(peaks, starts, 20000);
+    Drum_Trigger_Event_t event;
+    TEST_ASSERT_TRUE(drumTriggerPop(&event));
+    TEST_ASSERT_EQUAL_UINT8(0, event.channel);
+    TEST_ASSERT_FALSE(drumTriggerPop(&event));
+}
+
+void test_flam_on_two_pads_is_kept(void) {
+    // Two real hits at the same time on different pads both come out
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {50000, 45000};
+    double start = sampleIndex * SAMPLE_US;
+    double starts[DRUM_TRIGGER_CHANNELS] = {start, start + SAMPLE_US};
+    run(peaks, starts, 20000);
+    Drum_Trigger_Event_t first, second;
+    TEST_ASSERT_TRUE(drumTriggerPop(&first));
+    TEST_ASSERT_TRUE(drumTriggerPop(&second));
+    TEST_ASSERT_EQUAL_UINT8(0, first.channel);
+    TEST_ASSERT_EQUAL_UINT8(1, second.channel);
+}
+
+void test_hit_is_held_from_its_timestamp(void) {
+    uint32_t peaks[DRUM_TRIGGER_CHANNELS] = {0, 0, 0, 30000};
+    double start = sampleIndex * SAMPLE_US;
+    double starts[DRUM_TRIGGER_CHANNELS] = {0, 0, 0, start};
+    run(peaks, starts, DRUM_TRIGGER_SCAN_US * 2);
+    // The hit is detected once the scan window is over, give or take a couple of samples
+    uint32_t detected = start + DRUM_TRIGGER_SCAN_US;
+    uint32_t margin = SAMPLE_US * 4;
+    // The tick runs late, the hold still ends DRUM_TRIGGER_HOLD_US after the hit
+    drumTriggerTick(detected + DRUM_TRIGGER_HOLD_US / 2);
+    TEST_ASSERT_UINT_WITHIN(expectedPeak(30000) / 50, expectedPeak(30000), drumTriggerRead(3));
+    TEST_ASSERT_EQUAL_UINT16(0, drumTriggerRead(2));
+    drumTriggerTick(detected + DRUM_TRIGGER_HOLD_US - margin);
+    TEST_ASSERT_TRUE(drumTriggerRead(3) > 0);
+    drumTriggerTick(detected + DRUM_TRIGGER_HOLD_US + margin);
+    TEST_ASSERT_EQUAL_UINT16(0, drumTriggerRead(3));
+}
+
+void test_full_queue_drops_newest(void) {
+    for (uint8_t i = 0; i < DRUM_TRIGGER_QUEUE_SIZE + 4; i++) {
+        drumTriggerHit(i % DRUM_TRIGGER_CHANNELS, i);
+    }
+    Drum_Trigger_Event_t event;
+    uint8_t count = 0;
+    while (drumTriggerPop(&event)) {
+        TEST_ASSERT_EQUAL_UINT32(count, event.time);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_UINT8(DRUM_TRIGGER_QUEUE_SIZE - 1, count);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_noise_is_not_a_hit);
+    RUN_TEST(test_hit_is_timestamped_with_peak_velocity);
+    RUN_TEST(test_scan_finds_late_peak);
+    RUN_TEST(test_ringing_is_masked);
+    RUN_TEST(test_hit_after_mask_is_detected);
+    RUN_TEST(test_crosstalk_is_dropped);
+    RUN_TEST(test_flam_on_two_pads_is_kept);
+    RUN_TEST(test_hit_is_held_from_its_timestamp);
+    RUN_TEST(test_full_queue_drops_newest);
+    return UNITY_END();
+}
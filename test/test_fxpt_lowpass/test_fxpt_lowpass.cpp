@@ -0,0 +1,77 @@
+#include <math.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include "fxpt_math.h"
+
+// The float filter that fxpt_lowpass replaced
+static int16_t float_lowpass(int16_t previous, int32_t sample, int16_t alpha) {
+    float a = alpha / 32768.0f;
+    float x = sample > INT16_MAX ? INT16_MAX : (sample < INT16_MIN ? INT16_MIN : sample);
+    return (int16_t)(x * a + previous * (1.0f - a));
+}
+
+void setUp(void) {
+    srand(1234);
+}
+
+void tearDown(void) {}
+
+void test_matches_float_for_random_inputs(void) {
+    for (int i = 0; i < 1000000; i++) {
+        int16_t previous = (int16_t)(rand() & 0xFFFF);
+        int32_t sample = (int16_t)(rand() & 0xFFFF);
+        int16_t alpha = rand() & 0x7FFF;
+        int16_t expected = float_lowpass(previous, sample, alpha);
+        int16_t actual = fxpt_lowpass(previous, sample, alpha);
+        TEST_ASSERT_INT_WITHIN(1, expected, actual);
+    }
+}
+
+void test_matches_float_along_a_trace(void) {
+    // Every step of a noisy tilt trace stays within one LSB of the float filter, and the
+    // error doesn't build up over the trace either
+    int16_t fixed = 0;
+    float reference = 0;
+    int16_t alpha = 0.05 * 32768;
+    for (int i = 0; i < 10000; i++) {
+        int32_t sample = (int32_t)(16384 * sinf(i / 500.0f)) + (rand() % 2001) - 1000;
+        int16_t expected = float_lowpass(fixed, sample, alpha);
+        fixed = fxpt_lowpass(fixed, sample, alpha);
+        TEST_ASSERT_INT_WITHIN(1, expected, fixed);
+        reference += (sample - reference) * (alpha / 32768.0f);
+        TEST_ASSERT_INT_WITHIN(32, reference, fixed);
+    }
+}
+
+void test_settles_on_constant_input(void) {
+    int16_t y = 0;
+    for (int i = 0; i < 2000; i++) {
+        y = fxpt_lowpass(y, 10000, 0.01 * 32768);
+    }
+    // Truncation towards zero stops the output just short of the input
+    TEST_ASSERT_INT_WITHIN(100, 10000, y);
+    TEST_ASSERT_LESS_OR_EQUAL(10000, y);
+}
+
+void test_full_alpha_passes_input(void) {
+    TEST_ASSERT_INT_WITHIN(1, 1234, fxpt_lowpass(-5000, 1234, INT16_MAX));
+    TEST_ASSERT_INT_WITHIN(1, -1234, fxpt_lowpass(5000, -1234, INT16_MAX));
+}
+
+void test_saturates_large_samples(void) {
+    // A +-16g ADXL reading scaled by 64 doesn't fit in 16 bits
+    TEST_ASSERT_EQUAL_INT16(INT16_MAX, fxpt_lowpass(INT16_MAX, 4095 * 64L, 0.5 * 32768));
+    TEST_ASSERT_EQUAL_INT16(INT16_MIN, fxpt_lowpass(INT16_MIN, -4096 * 64L, 0.5 * 32768));
+    TEST_ASSERT_INT_WITHIN(1, float_lowpass(0, 4095 * 64L, 16384), fxpt_lowpass(0, 4095 * 64L, 16384));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_matches_float_for_random_inputs);
+    RUN_TEST(test_matches_float_along_a_trace);
+    RUN_TEST(test_settles_on_constant_input);
+    RUN_TEST(test_full_alpha_passes_input);
+    RUN_TEST(test_saturates_large_samples);
+    return UNITY_END();
+}
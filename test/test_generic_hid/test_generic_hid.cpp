@@ -0,0 +1,418 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+
+#include "generic_hid.h"
+
+static HID_Parser_Arena_t arena;
+static generic_plan_t *plan;
+static bool found_ps3;
+
+// Same as the USB host filter, PS3 controllers are picked out by this vendor feature report
+bool CALLBACK_HIDParser_FilterHIDReportItem(HID_ReportItem_t *const CurrentItem) {
+    if (CurrentItem->ItemType == HID_REPORT_ITEM_Feature && CurrentItem->Attributes.Usage.Page == 0xFF00 && CurrentItem->Attributes.Usage.Usage == 0x2621) {
+        found_ps3 = true;
+    }
+    return generic_hid_wants_item(CurrentItem);
+}
+
+// DragonRise generic USB encoder, used in plenty of cheap gamepads and dance pads
+static const uint8_t dragonrise_descriptor[] = {
+    0x05, 0x01, 0x09, 0x04, 0xA1, 0x01, 0xA1, 0x02, 0x75, 0x08, 0x95, 0x05, 0x15, 0x00, 0x26, 0xFF,
+    0x00, 0x35, 0x00, 0x46, 0xFF, 0x00, 0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x32, 0x09, 0x35,
+    0x81, 0x02, 0x75, 0x04, 0x95, 0x01, 0x25, 0x07, 0x46, 0x3B, 0x01, 0x65, 0x14, 0x09, 0x39, 0x81,
+    0x42, 0x65, 0x00, 0x75, 0x01, 0x95, 0x0C, 0x25, 0x01, 0x45, 0x01, 0x05, 0x09, 0x19, 0x01, 0x29,
+    0x0C, 0x81, 0x02, 0x06, 0x00, 0xFF, 0x75, 0x01, 0x95, 0x08, 0x25, 0x01, 0x45, 0x01, 0x09, 0x01,
+    0x81, 0x02, 0xC0, 0xA1, 0x02, 0x75, 0x08, 0x95, 0x07, 0x46, 0xFF, 0x00, 0x26, 0xFF, 0x00, 0x09,
+    0x02, 0x91, 0x02, 0xC0, 0xC0};
+
+// Logitech Dual Action, and the F310 / F710 in DirectInput mode
+static const uint8_t logitech_descriptor[] = {
+    0x05, 0x01, 0x09, 0x04, 0xA1, 0x01, 0xA1, 0x02, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x35, 0x00, 0x46,
+    0xFF, 0x00, 0x75, 0x08, 0x95, 0x04, 0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x35, 0x81, 0x02,
+    0x25, 0x07, 0x46, 0x3B, 0x01, 0x75, 0x04, 0x95, 0x01, 0x65, 0x14, 0x09, 0x39, 0x81, 0x42, 0x65,
+    0x00, 0x05, 0x09, 0x19, 0x01, 0x29, 0x0C, 0x25, 0x01, 0x45, 0x01, 0x75, 0x01, 0x95, 0x0C, 0x81,
+    0x02, 0x06, 0x00, 0xFF, 0x75, 0x01, 0x95, 0x10, 0x25, 0x01, 0x45, 0x01, 0x09, 0x01, 0x81, 0x02,
+    0xC0, 0xA1, 0x02, 0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x07, 0x09, 0x02, 0x91,
+    0x02, 0xC0, 0xC0};
+
+// Licensed PS3 controllers and instruments. The pressure axes list twelve vendor usages in a row
+static const uint8_t ps3_descriptor[] = {
+    0x05, 0x01, 0x09, 0x05, 0xA1, 0x01, 0x15, 0x00, 0x25, 0x01, 0x35, 0x00, 0x45, 0x01, 0x75, 0x01,
+    0x95, 0x0D, 0x05, 0x09, 0x19, 0x01, 0x29, 0x0D, 0x81, 0x02, 0x95, 0x03, 0x81, 0x01, 0x05, 0x01,
+    0x25, 0x07, 0x46, 0x3B, 0x01, 0x75, 0x04, 0x95, 0x01, 0x65, 0x14, 0x09, 0x39, 0x81, 0x42, 0x65,
+    0x00, 0x95, 0x01, 0x81, 0x01, 0x26, 0xFF, 0x00, 0x46, 0xFF, 0x00, 0x09, 0x30, 0x09, 0x31, 0x09,
+    0x32, 0x09, 0x35, 0x75, 0x08, 0x95, 0x04, 0x81, 0x02, 0x06, 0x00, 0xFF, 0x09, 0x20, 0x09, 0x21,
+    0x09, 0x22, 0x09, 0x23, 0x09, 0x24, 0x09, 0x25, 0x09, 0x26, 0x09, 0x27, 0x09, 0x28, 0x09, 0x29,
+    0x09, 0x2A, 0x09, 0x2B, 0x95, 0x0C, 0x81, 0x02, 0x0A, 0x21, 0x26, 0x95, 0x08, 0xB1, 0x02, 0x0A,
+    0x21, 0x26, 0x91, 0x02, 0x26, 0xFF, 0x03, 0x46, 0xFF, 0x03, 0x09, 0x2C, 0x09, 0x2D, 0x09, 0x2E,
+    0x09, 0x2F, 0x75, 0x10, 0x95, 0x04, 0x81, 0x02, 0xC0};
+
+// Written for this test: report 1 has buttons 1 - 8 and 10 bit X / Y axes, report 2 has a 10 bit slider that isn't byte aligned
+static const uint8_t report_id_descriptor[] = {
+    0x05, 0x01, 0x09, 0x05, 0xA1, 0x01,
+    0x85, 0x01,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x08, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x08, 0x81, 0x02,
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x15, 0x00, 0x26, 0xFF, 0x03, 0x75, 0x0A, 0x95, 0x02, 0x81, 0x02,
+    0x75, 0x04, 0x95, 0x01, 0x81, 0x03,
+    0x85, 0x02,
+    0x75, 0x04, 0x95, 0x01, 0x81, 0x03,
+    0x09, 0x36, 0x15, 0x00, 0x26, 0xFF, 0x03, 0x75, 0x0A, 0x95, 0x01, 0x81, 0x02,
+    0x75, 0x02, 0x95, 0x01, 0x81, 0x03,
+    0xC0};
+
+static generic_plan_t *compile(const uint8_t *descriptor, uint16_t length) {
+    HID_ReportInfo_t *info = NULL;
+    if (USB_ProcessHIDReport(&arena, descriptor, length, &info) != HID_PARSE_Successful) {
+        return NULL;
+    }
+    return compile_generic_plan(info);
+}
+
+void setUp(void) {
+    plan = NULL;
+    found_ps3 = false;
+}
+
+void tearDown(void) {
+    if (plan) {
+        plan->used = false;
+    }
+}
+
+void test_dragonrise_plan(void) {
+    plan = compile(dragonrise_descriptor, sizeof(dragonrise_descriptor));
+    TEST_ASSERT_NOT_NULL(plan);
+    TEST_ASSERT_FALSE(plan->using_report_ids);
+    TEST_ASSERT_EQUAL_UINT8(1, plan->report_count);
+    // Five axes, the hat and twelve buttons. The vendor bits are filtered out
+    TEST_ASSERT_EQUAL_UINT8(18, plan->reports[0].count);
+    TEST_ASSERT_EQUAL_UINT8(GENERIC_FIELD_HAT, plan->fields[5].field);
+    TEST_ASSERT_EQUAL_UINT16(40, plan->fields[5].bit_offset);
+    TEST_ASSERT_EQUAL_UINT8(4, plan->fields[5].bit_size);
+    TEST_ASSERT_EQUAL_UINT8(GENERIC_FIELD_BUTTON, plan->fields[6].field);
+    TEST_ASSERT_EQUAL_UINT16(44, plan->fields[6].bit_offset);
+}
+
+typedef struct {
+    const uint8_t *descriptor;
+    uint16_t length;
+    bool ps3;
+    uint8_t fields;
+} corpus_entry_t;
+
+static const corpus_entry_t corpus[] = {
+    {dragonrise_descriptor, sizeof(dragonrise_descriptor), false, 18},
+    {logitech_descriptor, sizeof(logitech_descriptor), false, 17},
+    {ps3_descriptor, sizeof(ps3_descriptor), true, 18},
+};
+
+void test_descriptor_corpus(void) {
+    for (uint8_t i = 0; i < sizeof(corpus) / sizeof(corpus[0]); i++) {
+        HID_ReportInfo_t *info = NULL;
+        found_ps3 = false;
+        TEST_ASSERT_EQUAL_UINT8(HID_PARSE_Successful, USB_ProcessHIDReport(&arena, corpus[i].descriptor, corpus[i].length, &info));
+        TEST_ASSERT_EQUAL(corpus[i].ps3, found_ps3);
+        plan = compile_generic_plan(info);
+        TEST_ASSERT_NOT_NULL(plan);
+        TEST_ASSERT_EQUAL_UINT8(1, plan->report_count);
+        TEST_ASSERT_EQUAL_UINT8(corpus[i].fields, plan->reports[0].count);
+        plan->used = false;
+        plan = NULL;
+    }
+}
+
+void test_ps3_decode(void) {
+    plan = compile(ps3_descriptor, sizeof(ps3_descriptor));
+    TEST_ASSERT_NOT_NULL(plan);
+    // Buttons 2 and 13, hat up-right, then X, Y, Z and Rz
+    uint8_t report[27] = {0x02, 0x10, 0x01, 0x00, 0x80, 0x40, 0xC0};
+    USB_Host_Data_t out;
+    decode_generic_report(plan, report, &out);
+    TEST_ASSERT_EQUAL_HEX16(0x1002, out.genericButtons);
+    TEST_ASSERT_TRUE(out.dpadUp);
+    TEST_ASSERT_TRUE(out.dpadRight);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, out.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, out.genericAxisY);
+    TEST_ASSERT_EQUAL_HEX16(0x4000, out.genericAxisZ);
+    TEST_ASSERT_EQUAL_HEX16(0xC000, out.genericAxisRz);
+}
+
+void test_dragonrise_decode(void) {
+    plan = compile(dragonrise_descriptor, sizeof(dragonrise_descriptor));
+    TEST_ASSERT_NOT_NULL(plan);
+    // X left, Y centered, hat down-left, buttons 1, 4 and 12
+    const uint8_t report[] = {0x00, 0x80, 0x7F, 0x7F, 0xFF, 0x95, 0x80, 0x00};
+    USB_Host_Data_t out;
+    decode_generic_report(plan, report, &out);
+    TEST_ASSERT_EQUAL_HEX16(0x0000, out.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, out.genericAxisY);
+    TEST_ASSERT_EQUAL_HEX16(0xFF00, out.genericAxisRz);
+    TEST_ASSERT_TRUE(out.dpadDown);
+    TEST_ASSERT_TRUE(out.dpadLeft);
+    TEST_ASSERT_FALSE(out.dpadUp);
+    TEST_ASSERT_FALSE(out.dpadRight);
+    TEST_ASSERT_EQUAL_HEX16(0x0809, out.genericButtons);
+}
+
+void test_dragonrise_hat_null_state(void) {
+    plan = compile(dragonrise_descriptor, sizeof(dragonrise_descriptor));
+    TEST_ASSERT_NOT_NULL(plan);
+    const uint8_t report[] = {0x80, 0x80, 0x80, 0x80, 0x80, 0x0F, 0x00, 0x00};
+    USB_Host_Data_t out;
+    decode_generic_report(plan, report, &out);
+    TEST_ASSERT_FALSE(out.dpadUp || out.dpadDown || out.dpadLeft || out.dpadRight);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericButtons);
+}
+
+void test_report_ids_are_grouped(void) {
+    plan = compile(report_id_descriptor, sizeof(report_id_descriptor));
+    TEST_ASSERT_NOT_NULL(plan);
+    TEST_ASSERT_TRUE(plan->using_report_ids);
+    TEST_ASSERT_EQUAL_UINT8(2, plan->report_count);
+    TEST_ASSERT_EQUAL_UINT8(1, plan->reports[0].report_id);
+    TEST_ASSERT_EQUAL_UINT8(0, plan->reports[0].first);
+    TEST_ASSERT_EQUAL_UINT8(10, plan->reports[0].count);
+    TEST_ASSERT_EQUAL_UINT8(2, plan->reports[1].report_id);
+    TEST_ASSERT_EQUAL_UINT8(10, plan->reports[1].first);
+    TEST_ASSERT_EQUAL_UINT8(1, plan->reports[1].count);
+    TEST_ASSERT_EQUAL_UINT8(GENERIC_FIELD_AXIS_SLIDER, plan->fields[10].field);
+    TEST_ASSERT_EQUAL_UINT16(4, plan->fields[10].bit_offset);
+    TEST_ASSERT_EQUAL_UINT8(10, plan->fields[10].bit_size);
+}
+
+void test_report_ids_decode(void) {
+    plan = compile(report_id_descriptor, sizeof(report_id_descriptor));
+    TEST_ASSERT_NOT_NULL(plan);
+    USB_Host_Data_t out;
+    // Buttons 1 and 3, X = 0x2A5, Y = 0x15A
+    const uint8_t first[] = {0x01, 0x05, 0xA5, 0x6A, 0x05};
+    decode_generic_report(plan, first, &out);
+    TEST_ASSERT_EQUAL_HEX16(0x0005, out.genericButtons);
+    TEST_ASSERT_EQUAL_HEX16(0x2A5 << 6, out.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0x15A << 6, out.genericAxisY);
+    // Slider = 0x3C3, only the fields in report 2 are set
+    const uint8_t second[] = {0x02, 0x30, 0x3C};
+    decode_generic_report(plan, second, &out);
+    TEST_ASSERT_EQUAL_HEX16(0x3C3 << 6, out.genericAxisSlider);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericButtons);
+    // Report ids the plan doesn't know about decode to nothing
+    const uint8_t unknown[] = {0x03, 0xFF, 0xFF, 0xFF, 0xFF};
+    decode_generic_report(plan, unknown, &out);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericButtons);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericAxisX);
+}
+
+void test_extract_bits_straddles_bytes(void) {
+    const uint8_t data[] = {0xC0, 0x5A, 0x03, 0xF0, 0xFF, 0x0F};
+    // 12 bits from bit 6 cover three bytes
+    TEST_ASSERT_EQUAL_HEX32(0xD6B, extract_bits(data, 6, 12));
+    // 16 bits from bit 28 cover three bytes
+    TEST_ASSERT_EQUAL_HEX32(0xFFFF, extract_bits(data, 28, 16));
+    // 10 bits from bit 8 cover two bytes and stop before the bits above them
+    TEST_ASSERT_EQUAL_HEX32(0x35A, extract_bits(data, 8, 10));
+    TEST_ASSERT_EQUAL_HEX32(0x3, extract_bits(data, 6, 2));
+}
+
+void test_plans_run_out(void) {
+    generic_plan_t *plans[GENERIC_PLAN_COUNT];
+    for (uint8_t i = 0; i < GENERIC_PLAN_COUNT; i++) {
+        plans[i] = compile(dragonrise_descriptor, sizeof(dragonrise_descriptor));
+        TEST_ASSERT_NOT_NULL(plans[i]);
+    }
+    TEST_ASSERT_NULL(compile(dragonrise_descriptor, sizeof(dragonrise_descriptor)));
+    // Freeing a plan lets the next device have it
+    plans[3]->used = false;
+    TEST_ASSERT_EQUAL_PTR(plans[3], compile(dragonrise_descriptor, sizeof(dragonrise_descriptor)));
+    for (uint8_t i = 0; i < GENERIC_PLAN_COUNT; i++) {
+        plans[i]->used = false;
+    }
+}
+
+// Builds a descriptor into buf: an application collection holding whatever body gives it
+static uint16_t build_descriptor(uint8_t *buf, const uint8_t *body, uint16_t body_length, uint8_t repeat) {
+    const uint8_t header[] = {0x05, 0x01, 0x09, 0x04, 0xA1, 0x01};
+    uint16_t length = 0;
+    memcpy(buf, header, sizeof(header));
+    length += sizeof(header);
+    for (uint8_t i = 0; i < repeat; i++) {
+        memcpy(buf + length, body, body_length);
+        // Bodies that start with a report id get a new one each time
+        if (body[0] == 0x85) {
+            buf[length + 1] = i + 1;
+        }
+        length += body_length;
+    }
+    buf[length++] = 0xC0;
+    return length;
+}
+
+void test_many_buttons_fit(void) {
+    // 64 buttons and an X axis. Only buttons 1 - 16 are kept, so the rest don't use up the report items
+    const uint8_t body[] = {0x05, 0x09, 0x19, 0x01, 0x29, 0x40, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x40, 0x81, 0x02,
+                            0x05, 0x01, 0x09, 0x30, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02};
+    uint8_t descriptor[128];
+    uint16_t length = build_descriptor(descriptor, body, sizeof(body), 1);
+    plan = compile(descriptor, length);
+    TEST_ASSERT_NOT_NULL(plan);
+    TEST_ASSERT_EQUAL_UINT8(17, plan->reports[0].count);
+    TEST_ASSERT_EQUAL_UINT16(64, plan->fields[16].bit_offset);
+}
+
+void test_too_many_report_items(void) {
+    // One X axis item per repeat, all of them kept
+    const uint8_t body[] = {0x09, 0x30, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02};
+    uint8_t descriptor[HID_MAX_REPORTITEMS * sizeof(body) + 16];
+    HID_ReportInfo_t *info = NULL;
+    uint16_t length = build_descriptor(descriptor, body, sizeof(body), HID_MAX_REPORTITEMS);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_Successful, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+    length = build_descriptor(descriptor, body, sizeof(body), HID_MAX_REPORTITEMS + 1);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_InsufficientReportItems, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+}
+
+void test_too_many_collections(void) {
+    // A physical collection per repeat, on top of the application collection
+    const uint8_t body[] = {0xA1, 0x00, 0x09, 0x30, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02, 0xC0};
+    uint8_t descriptor[HID_MAX_COLLECTIONS * sizeof(body) + 16];
+    HID_ReportInfo_t *info = NULL;
+    uint16_t length = build_descriptor(descriptor, body, sizeof(body), HID_MAX_COLLECTIONS - 1);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_Successful, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+    length = build_descriptor(descriptor, body, sizeof(body), HID_MAX_COLLECTIONS);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_InsufficientCollectionPaths, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+}
+
+void test_too_many_report_ids(void) {
+    // A new report id per repeat, each with one axis
+    const uint8_t body[] = {0x85, 0x01, 0x09, 0x30, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02};
+    uint8_t descriptor[HID_MAX_REPORT_IDS * sizeof(body) + 32];
+    HID_ReportInfo_t *info = NULL;
+    uint16_t length = build_descriptor(descriptor, body, sizeof(body), HID_MAX_REPORT_IDS);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_Successful, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+    length = build_descriptor(descriptor, body, sizeof(body), HID_MAX_REPORT_IDS + 1);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_InsufficientReportIDItems, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+}
+
+void test_too_many_usages(void) {
+    // Seventeen X usages listed in a row
+    uint8_t body[HID_USAGE_STACK_DEPTH * 2 + 12];
+    uint8_t used = 0;
+    for (uint8_t i = 0; i <= HID_USAGE_STACK_DEPTH; i++) {
+        body[used++] = 0x09;
+        body[used++] = 0x30;
+    }
+    const uint8_t input[] = {0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02};
+    memcpy(body + used, input, sizeof(input));
+    used += sizeof(input);
+    uint8_t descriptor[sizeof(body) + 16];
+    HID_ReportInfo_t *info = NULL;
+    uint16_t length = build_descriptor(descriptor, body, used, 1);
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_UsageListOverflow, USB_ProcessHIDReport(&arena, descriptor, length, &info));
+}
+
+// How reports were decoded before plans: walk every parsed item and pull its value out a bit at a time
+static void decode_by_walking_items(HID_ReportInfo_t *info, const uint8_t *report, USB_Host_Data_t *out) {
+    memset(out, 0, sizeof(USB_Host_Data_t));
+    uint8_t report_id = 0;
+    if (info->UsingReportIDs) {
+        report_id = *report++;
+    }
+    for (HID_ReportItem_t *item = info->FirstReportItem; item; item = item->Next) {
+        if (item->ItemType != HID_REPORT_ITEM_In || !USB_GetHIDReportItemInfo(report_id, report, item)) {
+            continue;
+        }
+        uint16_t usage = item->Attributes.Usage.Usage;
+        uint16_t axis = item->Value << (16 - item->Attributes.BitSize);
+        if (item->Attributes.Usage.Page == GENERIC_USAGE_PAGE_BUTTON) {
+            if (usage >= 1 && usage <= 16 && item->Value) {
+                out->genericButtons |= 1 << (usage - 1);
+            }
+            continue;
+        }
+        switch (usage) {
+            case GENERIC_USAGE_X:
+                out->genericAxisX = axis;
+                break;
+            case GENERIC_USAGE_Y:
+                out->genericAxisY = axis;
+                break;
+            case GENERIC_USAGE_Z:
+                out->genericAxisZ = axis;
+                break;
+            case GENERIC_USAGE_RZ:
+                out->genericAxisRz = axis;
+                break;
+            case GENERIC_USAGE_HAT_SWITCH:
+                out->dpadLeft = item->Value == 6 || item->Value == 5 || item->Value == 7;
+                out->dpadRight = item->Value == 3 || item->Value == 2 || item->Value == 1;
+                out->dpadUp = item->Value == 0 || item->Value == 1 || item->Value == 7;
+                out->dpadDown = item->Value == 5 || item->Value == 4 || item->Value == 3;
+                break;
+        }
+    }
+}
+
+// Not a pass / fail on speed beyond the plan being the faster of the two, the timings are printed for comparison
+void test_plan_beats_item_walk(void) {
+    HID_ReportInfo_t *info = NULL;
+    TEST_ASSERT_EQUAL_UINT8(HID_PARSE_Successful, USB_ProcessHIDReport(&arena, ps3_descriptor, sizeof(ps3_descriptor), &info));
+    plan = compile_generic_plan(info);
+    TEST_ASSERT_NOT_NULL(plan);
+    uint8_t report[27] = {0x02, 0x10, 0x01, 0x00, 0x80, 0x40, 0xC0};
+    USB_Host_Data_t walked;
+    USB_Host_Data_t planned;
+    decode_by_walking_items(info, report, &walked);
+    decode_generic_report(plan, report, &planned);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&walked, &planned, sizeof(USB_Host_Data_t)));
+    const uint32_t rounds = 200000;
+    volatile uint16_t sink = 0;
+    clock_t start = clock();
+    for (uint32_t i = 0; i < rounds; i++) {
+        report[1] = i;
+        decode_by_walking_items(info, report, &walked);
+        sink += walked.genericButtons;
+    }
+    clock_t walk = clock() - start;
+    start = clock();
+    for (uint32_t i = 0; i < rounds; i++) {
+        report[1] = i;
+        decode_generic_report(plan, report, &planned);
+        sink += planned.genericButtons;
+    }
+    clock_t planned_time = clock() - start;
+    char message[96];
+    snprintf(message, sizeof(message), "PS3 report: item walk %.1f ns, plan %.1f ns", (double)walk * 1e9 / CLOCKS_PER_SEC / rounds, (double)planned_time * 1e9 / CLOCKS_PER_SEC / rounds);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(planned_time < walk);
+}
+
+void test_no_plan_decodes_to_nothing(void) {
+    const uint8_t report[] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+    USB_Host_Data_t out;
+    memset(&out, 0xFF, sizeof(out));
+    decode_generic_report(NULL, report, &out);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericButtons);
+    TEST_ASSERT_EQUAL_HEX16(0, out.genericAxisX);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_dragonrise_plan);
+    RUN_TEST(test_descriptor_corpus);
+    RUN_TEST(test_dragonrise_decode);
+    RUN_TEST(test_ps3_decode);
+    RUN_TEST(test_dragonrise_hat_null_state);
+    RUN_TEST(test_report_ids_are_grouped);
+    RUN_TEST(test_report_ids_decode);
+    RUN_TEST(test_extract_bits_straddles_bytes);
+    RUN_TEST(test_plans_run_out);
+    RUN_TEST(test_no_plan_decodes_to_nothing);
+    RUN_TEST(test_many_buttons_fit);
+    RUN_TEST(test_too_many_report_items);
+    RUN_TEST(test_too_many_collections);
+    RUN_TEST(test_too_many_report_ids);
+    RUN_TEST(test_too_many_usages);
+    RUN_TEST(test_plan_beats_item_walk);
+    return UNITY_END();
+}
@@ -0,0 +1,120 @@
+#include <string.h>
+#include <unity.h>
+
+#include "defines.h"
+#include "ps2.h"
+#include "usb_host_merge.h"
+
+static uint8_t packet[BUFFER_SIZE];
+static USB_Host_Data_t decoded;
+
+// Builds an idle poll reply with the given id, buttons are active low and sticks are centered
+static void idle_reply(uint8_t id) {
+    memset(packet, 0, sizeof(packet));
+    packet[0] = 0xFF;
+    packet[1] = id;
+    packet[2] = 0x5A;
+    packet[3] = 0xFF;
+    packet[4] = 0xFF;
+    memset(packet + 5, PS3_STICK_CENTER, 4);
+}
+
+void setUp(void) {
+    idle_reply(0x73);
+}
+
+void tearDown(void) {}
+
+void test_idle_dualshock_is_at_rest(void) {
+    ps2DecodeUsbHostData(packet, PSX_DUALSHOCK_1_CONTROLLER, &decoded);
+    USB_Host_Data_t rest;
+    memset(&rest, 0, sizeof(rest));
+    TEST_ASSERT_EQUAL_MEMORY(&rest, &decoded, sizeof(rest));
+}
+
+void test_buttons(void) {
+    packet[3] = (uint8_t)~((1 << (PSB_START)) | (1 << (PSB_PAD_LEFT)));
+    packet[4] = (uint8_t)~((1 << (PSB_CROSS - 8)) | (1 << (PSB_L2 - 8)));
+    ps2DecodeUsbHostData(packet, PSX_DUALSHOCK_1_CONTROLLER, &decoded);
+    TEST_ASSERT_EQUAL(1, decoded.start);
+    TEST_ASSERT_EQUAL(1, decoded.dpadLeft);
+    TEST_ASSERT_EQUAL(1, decoded.a);
+    TEST_ASSERT_EQUAL(0, decoded.b);
+    TEST_ASSERT_EQUAL(0, decoded.back);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, decoded.leftTrigger);
+    TEST_ASSERT_EQUAL_HEX16(0, decoded.rightTrigger);
+    // Frets are only decoded for guitars
+    TEST_ASSERT_EQUAL(0, decoded.blue);
+}
+
+void test_sticks(void) {
+    packet[5] = 0xFF;
+    packet[6] = 0x00;
+    packet[7] = 0x00;
+    packet[8] = 0xFF;
+    ps2DecodeUsbHostData(packet, PSX_DUALSHOCK_1_CONTROLLER, &decoded);
+    TEST_ASSERT_EQUAL_INT16(0x7F00, decoded.rightStickX);
+    TEST_ASSERT_EQUAL_INT16(0x7F00, decoded.rightStickY);
+    TEST_ASSERT_EQUAL_INT16(-0x8000, decoded.leftStickX);
+    TEST_ASSERT_EQUAL_INT16(-0x8000, decoded.leftStickY);
+}
+
+void test_digital_reply_has_no_sticks(void) {
+    idle_reply(0x41);
+    // A digital reply ends after the buttons, so whatever follows is ignored
+    packet[5] = 0x00;
+    ps2DecodeUsbHostData(packet, PSX_DIGITAL, &decoded);
+    TEST_ASSERT_EQUAL_INT16(0, decoded.rightStickX);
+}
+
+void test_pressures(void) {
+    idle_reply(0x79);
+    packet[4] = (uint8_t)~(1 << (PSB_R2 - 8));
+    packet[9] = 0x11;
+    packet[16] = 0x22;
+    packet[17] = 0x33;
+    packet[20] = 0x40;
+    ps2DecodeUsbHostData(packet, PSX_DUALSHOCK_2_CONTROLLER, &decoded);
+    TEST_ASSERT_EQUAL_HEX8(0x11, decoded.pressureDpadRight);
+    TEST_ASSERT_EQUAL_HEX8(0x22, decoded.pressureSquare);
+    TEST_ASSERT_EQUAL_HEX8(0x33, decoded.pressureL1);
+    // The pressure replaces the digital trigger value
+    TEST_ASSERT_EQUAL_HEX16(0x4000, decoded.rightTrigger);
+}
+
+void test_guitar_frets(void) {
+    packet[4] = (uint8_t)~((1 << (PSB_R2 - 8)) | (1 << (PSB_SQUARE - 8)));
+    ps2DecodeUsbHostData(packet, PSX_GUITAR_HERO_CONTROLLER, &decoded);
+    TEST_ASSERT_EQUAL(1, decoded.green);
+    TEST_ASSERT_EQUAL(1, decoded.orange);
+    TEST_ASSERT_EQUAL(0, decoded.red);
+}
+
+void test_multitap_ports_merge(void) {
+    // Port B holds a stick while port C is idle, the merged result keeps port B's stick
+    USB_Host_Data_t merged, portB, portC;
+    reset_usb_host_data(&merged);
+    packet[7] = 0x00;
+    packet[4] = (uint8_t)~(1 << (PSB_CIRCLE - 8));
+    ps2DecodeUsbHostData(packet, PSX_DUALSHOCK_1_CONTROLLER, &portB);
+    idle_reply(0x73);
+    packet[3] = (uint8_t)~(1 << (PSB_START));
+    ps2DecodeUsbHostData(packet, PSX_DUALSHOCK_1_CONTROLLER, &portC);
+    merge_usb_host_data(&merged, &portB);
+    merge_usb_host_data(&merged, &portC);
+    TEST_ASSERT_EQUAL_INT16(-0x8000, merged.leftStickX);
+    TEST_ASSERT_EQUAL(1, merged.b);
+    TEST_ASSERT_EQUAL(1, merged.start);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_idle_dualshock_is_at_rest);
+    RUN_TEST(test_buttons);
+    RUN_TEST(test_sticks);
+    RUN_TEST(test_digital_reply_has_no_sticks);
+    RUN_TEST(test_pressures);
+    RUN_TEST(test_guitar_frets);
+    RUN_TEST(test_multitap_ports_merge);
+    return UNITY_END();
+}
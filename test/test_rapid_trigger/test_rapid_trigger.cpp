@@ -0,0 +1,173 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "rapid_trigger.h"
+
+#define ACTUATION 8192
+#define PRESS_DELTA 2048
+#define RELEASE_DELTA 1024
+
+// The traces below are modelled on a magnetic switch rather than recorded from one: a 4 mm key
+// with the magnet 2 mm from the sensor when bottomed out, so the field falls off with the square of
+// the gap and most of the reading changes near the bottom of the travel. The reading is calibrated
+// from rest to bottom, and has +-NOISE LSB of noise from a 12 bit ADC, scaled up to 16 bits.
+#define KEY_TRAVEL_MM 4.0
+#define MAGNET_GAP_MM 2.0
+#define NOISE 3
+
+static bool feed(uint16_t travel) {
+    return rapidTrigger(0, travel, ACTUATION, PRESS_DELTA, RELEASE_DELTA);
+}
+
+static double field(double mm) {
+    double gap = MAGNET_GAP_MM + KEY_TRAVEL_MM - mm;
+    return MAGNET_GAP_MM * MAGNET_GAP_MM / (gap * gap);
+}
+
+static uint16_t hall(double mm) {
+    double calibrated = (field(mm) - field(0)) / (field(KEY_TRAVEL_MM) - field(0));
+    int32_t adc = lround(calibrated * 4095) + (rand() % (NOISE * 2 + 1)) - NOISE;
+    if (adc < 0) {
+        adc = 0;
+    }
+    if (adc > 4095) {
+        adc = 4095;
+    }
+    return adc << 4;
+}
+
+// Follows a key position for the given number of 1 ms polls, and returns how many presses were seen
+static uint16_t play(double (*position)(uint32_t ms), uint32_t polls, bool *pressed) {
+    uint16_t presses = 0;
+    for (uint32_t ms = 0; ms < polls; ms++) {
+        bool now = rapidTrigger(0, hall(position(ms)));
+        if (now && !*pressed) {
+            presses++;
+        }
+        *pressed = now;
+    }
+    return presses;
+}
+
+static double atRest(uint32_t ms) {
+    return 0;
+}
+
+static double bottomedOut(uint32_t ms) {
+    return KEY_TRAVEL_MM;
+}
+
+static double halfway(uint32_t ms) {
+    return KEY_TRAVEL_MM / 2;
+}
+
+// Fast tapping at 10 Hz between 2.8 mm and the bottom, never letting the key come back up
+static double tapping(uint32_t ms) {
+    return 3.4 + 0.6 * cos(2 * M_PI * ms / 100.0);
+}
+
+void setUp(void) {
+    srand(1);
+    memset(rapidTriggers, 0, sizeof(rapidTriggers));
+}
+
+void tearDown(void) {}
+
+void test_press_from_rest(void) {
+    TEST_ASSERT_FALSE(feed(0));
+    TEST_ASSERT_FALSE(feed(ACTUATION - 1));
+    // Coming up from rest, crossing the actuation point is enough, no press delta needed
+    TEST_ASSERT_TRUE(feed(ACTUATION));
+}
+
+void test_release_by_delta(void) {
+    feed(0);
+    TEST_ASSERT_TRUE(feed(20000));
+    TEST_ASSERT_TRUE(feed(30000));
+    // Releases are measured from the deepest point, not from where it was pressed
+    TEST_ASSERT_TRUE(feed(30000 - RELEASE_DELTA + 1));
+    TEST_ASSERT_FALSE(feed(30000 - RELEASE_DELTA));
+}
+
+void test_repress_by_delta(void) {
+    feed(0);
+    feed(30000);
+    TEST_ASSERT_FALSE(feed(25000));
+    // Still above the actuation point, so the next press is measured from the highest point since the release
+    TEST_ASSERT_FALSE(feed(20000));
+    TEST_ASSERT_FALSE(feed(20000 + PRESS_DELTA - 1));
+    TEST_ASSERT_TRUE(feed(20000 + PRESS_DELTA));
+}
+
+void test_actuation_guard(void) {
+    feed(0);
+    TEST_ASSERT_TRUE(feed(ACTUATION + 100));
+    // Less than a release delta of movement, but above the actuation point is always released
+    TEST_ASSERT_FALSE(feed(ACTUATION - 1));
+    // And the next press is from rest again
+    TEST_ASSERT_TRUE(feed(ACTUATION));
+}
+
+void test_inputs_are_independent(void) {
+    TEST_ASSERT_TRUE(rapidTrigger(1, 30000, ACTUATION, PRESS_DELTA, RELEASE_DELTA));
+    TEST_ASSERT_FALSE(rapidTrigger(2, 0, ACTUATION, PRESS_DELTA, RELEASE_DELTA));
+    TEST_ASSERT_TRUE(rapidTrigger(1, 29000, ACTUATION, PRESS_DELTA, RELEASE_DELTA));
+}
+
+void test_hall_noise_does_not_chatter(void) {
+    bool pressed = false;
+    TEST_ASSERT_EQUAL_UINT16(0, play(atRest, 2000, &pressed));
+    TEST_ASSERT_EQUAL_UINT16(1, play(bottomedOut, 2000, &pressed));
+    TEST_ASSERT_TRUE(pressed);
+    // Held part of the way down, the noise is well inside the release delta
+    memset(rapidTriggers, 0, sizeof(rapidTriggers));
+    pressed = false;
+    TEST_ASSERT_EQUAL_UINT16(1, play(halfway, 2000, &pressed));
+    TEST_ASSERT_TRUE(pressed);
+}
+
+void test_hall_tapping_without_full_release(void) {
+    // The key never comes back above the actuation point, so a fixed threshold would see one long press
+    TEST_ASSERT_TRUE(hall(2.8) > RAPID_TRIGGER_ACTUATION);
+    bool pressed = false;
+    play(atRest, 100, &pressed);
+    // The first press coming from rest, then one for each of the ten times the key comes up and goes back down
+    TEST_ASSERT_EQUAL_UINT16(1 + 10, play(tapping, 1000, &pressed));
+}
+
+void test_hall_release_distance(void) {
+    // Let a bottomed out key come back up slowly, and see how far it moved before it was released
+    bool pressed = false;
+    play(bottomedOut, 100, &pressed);
+    double mm = KEY_TRAVEL_MM;
+    while (rapidTrigger(0, hall(mm))) {
+        mm -= 0.001;
+    }
+    double released = KEY_TRAVEL_MM - mm;
+    char message[64];
+    snprintf(message, sizeof(message), "released after %.3f mm of a %.1f mm key", released, KEY_TRAVEL_MM);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(released < 0.2);
+    // And pressing again only needs a small move back down, far above the actuation point
+    double bottom = mm;
+    while (!rapidTrigger(0, hall(mm))) {
+        mm += 0.001;
+    }
+    TEST_ASSERT_TRUE(mm - bottom < 0.2);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_press_from_rest);
+    RUN_TEST(test_release_by_delta);
+    RUN_TEST(test_repress_by_delta);
+    RUN_TEST(test_actuation_guard);
+    RUN_TEST(test_inputs_are_independent);
+    RUN_TEST(test_hall_noise_does_not_chatter);
+    RUN_TEST(test_hall_tapping_without_full_release);
+    RUN_TEST(test_hall_release_distance);
+    return UNITY_END();
+}
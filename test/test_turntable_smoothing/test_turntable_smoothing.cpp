@@ -0,0 +1,142 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "turntable_smoothing.h"
+
+// Benchmarks the filter against the 16 sample moving average it replaced, over traces shaped like
+// what a DJ Hero platter reports: a signed speed per poll with +-2 counts of jitter.
+#define TRACE_LENGTH 600
+#define JITTER 2
+
+typedef enum {
+    TRACE_STEADY,
+    TRACE_RAMP,
+    TRACE_SCRATCH
+} Trace_t;
+
+typedef struct {
+    int8_t buffer[16];
+    uint8_t next;
+    int32_t sum;
+} Moving_Average_t;
+
+static Turntable_Smoothing_t smoothing;
+static Moving_Average_t average;
+
+static int8_t movingAverage(Moving_Average_t *average, int8_t reading) {
+    average->sum -= average->buffer[average->next];
+    average->buffer[average->next] = reading;
+    average->sum += reading;
+    average->next = (average->next + 1) % 16;
+    return average->sum / 16;
+}
+
+// What the platter is actually doing at each poll
+static double truth(Trace_t trace, int t) {
+    switch (trace) {
+        case TRACE_STEADY:
+            return 8;
+        case TRACE_RAMP:
+            // Slowly spinning the platter up
+            return t < 400 ? t * 30.0 / 400 : 30;
+        case TRACE_SCRATCH:
+            // Scratch forward, then back, then let go
+            return t < 50 ? 0 : t < 150 ? 60 : t < 250 ? -60 : 0;
+    }
+    return 0;
+}
+
+static int8_t reading(Trace_t trace, int t) {
+    return lround(truth(trace, t)) + (rand() % (JITTER * 2 + 1)) - JITTER;
+}
+
+// RMS error of both filters over a trace, skipping the first polls of a steady trace while they fill up
+static void measure(Trace_t trace, double *filterError, double *averageError) {
+    double filterSum = 0;
+    double averageSum = 0;
+    int count = 0;
+    for (int t = 0; t < TRACE_LENGTH; t++) {
+        int8_t value = reading(trace, t);
+        smoothTurntable(&smoothing, value);
+        double filterDelta = smoothedTurntable(&smoothing) - truth(trace, t);
+        double averageDelta = movingAverage(&average, value) - truth(trace, t);
+        if (trace == TRACE_STEADY && t < 100) {
+            continue;
+        }
+        filterSum += filterDelta * filterDelta;
+        averageSum += averageDelta * averageDelta;
+        count++;
+    }
+    *filterError = sqrt(filterSum / count);
+    *averageError = sqrt(averageSum / count);
+    char message[64];
+    snprintf(message, sizeof(message), "rms error %.2f, moving average %.2f", *filterError, *averageError);
+    TEST_MESSAGE(message);
+}
+
+void setUp(void) {
+    srand(1);
+    memset(&smoothing, 0, sizeof(smoothing));
+    memset(&average, 0, sizeof(average));
+}
+
+void tearDown(void) {}
+
+void test_steady_platter_is_less_noisy(void) {
+    double filterError, averageError;
+    measure(TRACE_STEADY, &filterError, &averageError);
+    TEST_ASSERT_TRUE(filterError < averageError);
+    // The jitter alone is about 1.4 counts rms
+    TEST_ASSERT_TRUE(filterError < 0.5);
+}
+
+void test_slow_ramp_lags_less(void) {
+    double filterError, averageError;
+    measure(TRACE_RAMP, &filterError, &averageError);
+    TEST_ASSERT_TRUE(filterError < averageError);
+}
+
+void test_scratch_lags_less(void) {
+    double filterError, averageError;
+    measure(TRACE_SCRATCH, &filterError, &averageError);
+    TEST_ASSERT_TRUE(filterError * 10 < averageError);
+}
+
+void test_scratch_settles_quickly(void) {
+    // Without jitter, count the polls until a scratch is within 2 counts of the platter
+    for (int i = 0; i < 50; i++) {
+        smoothTurntable(&smoothing, 0);
+    }
+    int polls = 0;
+    do {
+        smoothTurntable(&smoothing, 60);
+        polls++;
+    } while (abs(smoothedTurntable(&smoothing) - 60) > 2);
+    TEST_ASSERT_LESS_OR_EQUAL(3, polls);
+}
+
+void test_slow_ramp_lag_in_polls(void) {
+    // A ramp of 1 count every 4 polls doesn't open the filter up, so this is the lag at MIN_ALPHA
+    int t;
+    for (t = 0; t < 400; t++) {
+        smoothTurntable(&smoothing, t / 4);
+    }
+    double lagPolls = (t / 4.0 - smoothedTurntable(&smoothing)) * 4;
+    char message[64];
+    snprintf(message, sizeof(message), "slow ramp lag %.1f polls, moving average 7.5", lagPolls);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(lagPolls <= 8);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_steady_platter_is_less_noisy);
+    RUN_TEST(test_slow_ramp_lags_less);
+    RUN_TEST(test_scratch_lags_less);
+    RUN_TEST(test_scratch_settles_quickly);
+    RUN_TEST(test_slow_ramp_lag_in_polls);
+    return UNITY_END();
+}
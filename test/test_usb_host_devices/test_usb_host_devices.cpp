@@ -0,0 +1,121 @@
+#include <string.h>
+#include <unity.h>
+
+#include "usb_host_devices.h"
+
+static void mount(uint8_t console_type, uint8_t dev_addr, uint8_t instance) {
+    USB_Device_Type_t type = {console_type, 0, dev_addr, instance};
+    add_usb_host_device(type);
+}
+
+static int slot_of(uint8_t dev_addr, uint8_t instance) {
+    Usb_Host_Device_t *device = find_usb_host_device(dev_addr, instance);
+    return device ? device - usb_host_devices : -1;
+}
+
+void setUp(void) {
+    memset(usb_host_devices, 0, sizeof(usb_host_devices));
+    memset(usb_host_slots, 0, sizeof(usb_host_slots));
+    memset(usb_host_devices_by_type, 0, sizeof(usb_host_devices_by_type));
+    total_usb_host_devices = 0;
+}
+
+void tearDown(void) {}
+
+void test_mount_takes_lowest_slots(void) {
+    mount(XBOX360, 1, 0);
+    mount(PS3, 2, 0);
+    mount(XBOX360, 3, 0);
+    TEST_ASSERT_EQUAL_UINT8(3, total_usb_host_devices);
+    TEST_ASSERT_EQUAL_PTR(&usb_host_devices[0], find_usb_host_device(1, 0));
+    TEST_ASSERT_EQUAL_PTR(&usb_host_devices[1], find_usb_host_device(2, 0));
+    TEST_ASSERT_EQUAL_PTR(&usb_host_devices[2], find_usb_host_device(3, 0));
+    TEST_ASSERT_EQUAL_UINT8(1, usb_host_devices[1].generation);
+    TEST_ASSERT_EQUAL_HEX32(0b101, usb_host_devices_by_type[XBOX360]);
+    TEST_ASSERT_EQUAL_HEX32(0b010, usb_host_devices_by_type[PS3]);
+}
+
+void test_unplug_middle_keeps_other_slots(void) {
+    mount(XBOX360, 1, 0);
+    mount(PS3, 2, 0);
+    mount(XBOX360, 3, 0);
+    remove_usb_host_device(2, 0);
+    TEST_ASSERT_NULL(find_usb_host_device(2, 0));
+    TEST_ASSERT_FALSE(usb_host_devices[1].used);
+    TEST_ASSERT_EQUAL_UINT8(0, usb_host_devices_by_type[PS3]);
+    // The freed slot is below the last one in use, so nothing shrinks
+    TEST_ASSERT_EQUAL_UINT8(3, total_usb_host_devices);
+    TEST_ASSERT_EQUAL_INT(0, slot_of(1, 0));
+    TEST_ASSERT_EQUAL_INT(2, slot_of(3, 0));
+}
+
+void test_replug_reuses_slot_with_new_generation(void) {
+    mount(XBOX360, 1, 0);
+    mount(PS3, 2, 0);
+    mount(XBOX360, 3, 0);
+    usb_host_devices[1].report_length = 10;
+    remove_usb_host_device(2, 0);
+    // TinyUSB hands out a new address on replug
+    mount(PS4, 4, 0);
+    TEST_ASSERT_EQUAL_INT(1, slot_of(4, 0));
+    TEST_ASSERT_EQUAL_UINT8(2, usb_host_devices[1].generation);
+    TEST_ASSERT_EQUAL_UINT8(0, usb_host_devices[1].report_length);
+    TEST_ASSERT_TRUE(usb_host_devices[1].changed);
+    TEST_ASSERT_EQUAL_HEX32(0b010, usb_host_devices_by_type[PS4]);
+    TEST_ASSERT_EQUAL_UINT8(1, usb_host_devices[0].generation);
+    TEST_ASSERT_EQUAL_UINT8(1, usb_host_devices[2].generation);
+    TEST_ASSERT_EQUAL_UINT8(3, total_usb_host_devices);
+}
+
+void test_unplug_last_shrinks_total(void) {
+    mount(XBOX360, 1, 0);
+    mount(PS3, 2, 0);
+    mount(XBOX360, 3, 0);
+    remove_usb_host_device(2, 0);
+    remove_usb_host_device(3, 0);
+    // Both trailing free slots are dropped
+    TEST_ASSERT_EQUAL_UINT8(1, total_usb_host_devices);
+    remove_usb_host_device(1, 0);
+    TEST_ASSERT_EQUAL_UINT8(0, total_usb_host_devices);
+    TEST_ASSERT_EQUAL_HEX32(0, usb_host_devices_by_type[XBOX360]);
+}
+
+void test_instances_get_their_own_slots(void) {
+    mount(XBOX360, 1, 0);
+    mount(XBOX360, 1, 1);
+    mount(XBOX360, 1, 3);
+    TEST_ASSERT_EQUAL_INT(1, slot_of(1, 1));
+    TEST_ASSERT_EQUAL_INT(2, slot_of(1, 3));
+    TEST_ASSERT_NULL(find_usb_host_device(1, 2));
+    remove_usb_host_device(1, 1);
+    TEST_ASSERT_EQUAL_INT(0, slot_of(1, 0));
+    TEST_ASSERT_EQUAL_INT(2, slot_of(1, 3));
+}
+
+void test_identifying_devices_stay_out_of_type_masks(void) {
+    USB_Device_Type_t type = {PS3, 0, 1, 0};
+    add_usb_host_device(type, USB_HOST_IDENTIFY_DEVICE);
+    TEST_ASSERT_NOT_NULL(find_usb_host_device(1, 0));
+    TEST_ASSERT_EQUAL_HEX32(0, usb_host_devices_by_type[PS3]);
+}
+
+void test_invalid_and_unknown_devices_are_ignored(void) {
+    mount(XBOX360, 0, 0);
+    mount(XBOX360, CFG_TUH_DEVICE_MAX + 1, 0);
+    mount(XBOX360, 1, CFG_TUH_XINPUT);
+    TEST_ASSERT_EQUAL_UINT8(0, total_usb_host_devices);
+    remove_usb_host_device(5, 0);
+    TEST_ASSERT_EQUAL_UINT8(0, total_usb_host_devices);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_mount_takes_lowest_slots);
+    RUN_TEST(test_unplug_middle_keeps_other_slots);
+    RUN_TEST(test_replug_reuses_slot_with_new_generation);
+    RUN_TEST(test_unplug_last_shrinks_total);
+    RUN_TEST(test_instances_get_their_own_slots);
+    RUN_TEST(test_identifying_devices_stay_out_of_type_masks);
+    RUN_TEST(test_invalid_and_unknown_devices_are_ignored);
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include <string.h>
+#include <unity.h>
+
+#include "usb_host_merge.h"
+
+static USB_Host_Data_t merged;
+static USB_Host_Data_t active;
+static USB_Host_Data_t idle;
+
+void setUp(void) {
+    reset_usb_host_data(&merged);
+    reset_usb_host_data(&active);
+    reset_usb_host_data(&idle);
+}
+
+void tearDown(void) {}
+
+void test_reset_uses_rest_values(void) {
+    TEST_ASSERT_EQUAL_HEX8(0x80, merged.slider);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, merged.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, merged.genericAxisRz);
+    TEST_ASSERT_EQUAL_HEX16(PS3_ACCEL_CENTER, merged.accelX);
+    TEST_ASSERT_EQUAL_HEX16(PS3_ACCEL_CENTER, merged.gyro);
+    TEST_ASSERT_EQUAL_INT(0, merged.leftStickX);
+    TEST_ASSERT_EQUAL_HEX16(0, merged.genericButtons);
+}
+
+void test_idle_generic_pad_keeps_active_axis(void) {
+    active.genericAxisX = 0xFFFF;
+    active.genericAxisY = 0x0000;
+    merge_usb_host_data(&merged, &active);
+    merge_usb_host_data(&merged, &idle);
+    TEST_ASSERT_EQUAL_HEX16(0xFFFF, merged.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, merged.genericAxisY);
+}
+
+void test_idle_values_keep_active_ones(void) {
+    active.leftStickX = -20000;
+    active.slider = 0x20;
+    active.accelX = 0x300;
+    active.whammy = 0x7F;
+    merge_usb_host_data(&merged, &active);
+    merge_usb_host_data(&merged, &idle);
+    TEST_ASSERT_EQUAL_INT(-20000, merged.leftStickX);
+    TEST_ASSERT_EQUAL_HEX8(0x20, merged.slider);
+    TEST_ASSERT_EQUAL_HEX16(0x300, merged.accelX);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, merged.whammy);
+}
+
+void test_devices_without_a_value_count_as_idle(void) {
+    // Decoders that don't have an axis leave it at 0, even where the rest value isn't 0
+    USB_Host_Data_t missing;
+    memset(&missing, 0, sizeof(missing));
+    active.genericAxisX = 0x1234;
+    active.accelZ = 0x180;
+    merge_usb_host_data(&merged, &active);
+    merge_usb_host_data(&merged, &missing);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, merged.genericAxisX);
+    TEST_ASSERT_EQUAL_HEX16(0x180, merged.accelZ);
+    TEST_ASSERT_EQUAL_HEX8(0x80, merged.slider);
+}
+
+void test_last_active_device_wins(void) {
+    USB_Host_Data_t other;
+    reset_usb_host_data(&other);
+    active.leftStickY = 1000;
+    other.leftStickY = -1000;
+    merge_usb_host_data(&merged, &active);
+    merge_usb_host_data(&merged, &other);
+    TEST_ASSERT_EQUAL_INT(-1000, merged.leftStickY);
+}
+
+void test_buttons_are_combined(void) {
+    USB_Host_Data_t other;
+    reset_usb_host_data(&other);
+    active.a = true;
+    active.genericButtons = 0x0001;
+    active.keyboard.a = true;
+    other.dpadUp = true;
+    other.genericButtons = 0x8000;
+    merge_usb_host_data(&merged, &active);
+    merge_usb_host_data(&merged, &other);
+    merge_usb_host_data(&merged, &idle);
+    TEST_ASSERT_TRUE(merged.a);
+    TEST_ASSERT_TRUE(merged.dpadUp);
+    TEST_ASSERT_TRUE(merged.keyboard.a);
+    TEST_ASSERT_EQUAL_HEX16(0x8001, merged.genericButtons);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reset_uses_rest_values);
+    RUN_TEST(test_idle_generic_pad_keeps_active_axis);
+    RUN_TEST(test_idle_values_keep_active_ones);
+    RUN_TEST(test_devices_without_a_value_count_as_idle);
+    RUN_TEST(test_last_active_device_wins);
+    RUN_TEST(test_buttons_are_combined);
+    return UNITY_END();
+}
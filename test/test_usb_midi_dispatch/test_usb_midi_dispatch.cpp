@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+
+#include "usb_midi_dispatch.h"
+
+#define CABLE 0
+// A full 64 byte bulk transfer holds 16 packets
+#define BURST 16
+
+static UsbMidiHandlers handlers;
+static uint8_t lastChannel, lastNote, lastVelocity, lastNumber, lastValue;
+static int lastBend;
+static uint8_t noteOns, noteOffs, controlChanges, pitchBends;
+// When each packet of a burst was handled
+static uint64_t handledAt[BURST];
+
+static uint64_t nanos() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void onNoteOn(uint8_t channel, uint8_t note, uint8_t velocity) {
+    lastChannel = channel;
+    lastNote = note;
+    lastVelocity = velocity;
+    if (noteOns < BURST) {
+        handledAt[noteOns] = nanos();
+    }
+    noteOns++;
+}
+
+static void onNoteOff(uint8_t channel, uint8_t note, uint8_t velocity) {
+    lastChannel = channel;
+    lastNote = note;
+    lastVelocity = velocity;
+    noteOffs++;
+}
+
+static void onControlChange(uint8_t channel, uint8_t number, uint8_t value) {
+    lastChannel = channel;
+    lastNumber = number;
+    lastValue = value;
+    controlChanges++;
+}
+
+static void onPitchBend(uint8_t channel, int bend) {
+    lastChannel = channel;
+    lastBend = bend;
+    pitchBends++;
+}
+
+void setUp(void) {
+    handlers = UsbMidiHandlers();
+    handlers.handleNoteOn = onNoteOn;
+    handlers.handleNoteOff = onNoteOff;
+    handlers.handleControlChange = onControlChange;
+    handlers.handlePitchBend = onPitchBend;
+    noteOns = noteOffs = controlChanges = pitchBends = 0;
+    lastChannel = lastNote = lastVelocity = lastNumber = lastValue = 0;
+    lastBend = 0;
+}
+
+void tearDown(void) {}
+
+void test_note_on(void) {
+    uint8_t packet[4] = {0x09, 0x92, 60, 100};
+    handlers.dispatch(CABLE, packet);
+    TEST_ASSERT_EQUAL_UINT8(1, noteOns);
+    TEST_ASSERT_EQUAL_UINT8(3, lastChannel);
+    TEST_ASSERT_EQUAL_UINT8(60, lastNote);
+    TEST_ASSERT_EQUAL_UINT8(100, lastVelocity);
+}
+
+void test_note_on_without_velocity_is_note_off(void) {
+    uint8_t packet[4] = {0x09, 0x90, 60, 0};
+    handlers.dispatch(CABLE, packet);
+    TEST_ASSERT_EQUAL_UINT8(0, noteOns);
+    TEST_ASSERT_EQUAL_UINT8(1, noteOffs);
+}
+
+void test_control_change_and_pitch_bend(void) {
+    uint8_t control[4] = {0x0B, 0xB0, 64, 127};
+    handlers.dispatch(CABLE, control);
+    TEST_ASSERT_EQUAL_UINT8(1, controlChanges);
+    TEST_ASSERT_EQUAL_UINT8(64, lastNumber);
+    TEST_ASSERT_EQUAL_UINT8(127, lastValue);
+    uint8_t centre[4] = {0x0E, 0xE0, 0x00, 0x40};
+    handlers.dispatch(CABLE, centre);
+    TEST_ASSERT_EQUAL_INT(0, lastBend);
+    uint8_t lowest[4] = {0x0E, 0xE0, 0x00, 0x00};
+    handlers.dispatch(CABLE, lowest);
+    TEST_ASSERT_EQUAL_INT(-8192, lastBend);
+    TEST_ASSERT_EQUAL_UINT8(2, pitchBends);
+}
+
+void test_other_cables_are_ignored(void) {
+    uint8_t packet[4] = {0x19, 0x90, 60, 100};
+    handlers.dispatch(CABLE, packet);
+    TEST_ASSERT_EQUAL_UINT8(0, noteOns);
+}
+
+void test_missing_handlers_are_skipped(void) {
+    // Only note on is set, everything else has to be dropped instead of calling through null
+    UsbMidiHandlers only;
+    TEST_ASSERT_FALSE(only.hasHandlers());
+    only.handleNoteOn = onNoteOn;
+    TEST_ASSERT_TRUE(only.hasHandlers());
+    uint8_t packets[][4] = {
+        {0x08, 0x80, 60, 0},
+        {0x09, 0x90, 60, 0},
+        {0x0B, 0xB0, 1, 2},
+        {0x0E, 0xE0, 0, 0},
+        {0x09, 0x90, 60, 1},
+    };
+    for (uint8_t i = 0; i < sizeof(packets) / sizeof(packets[0]); i++) {
+        only.dispatch(CABLE, packets[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, noteOns);
+    TEST_ASSERT_EQUAL_UINT8(0, noteOffs + controlChanges + pitchBends);
+    // And a transport with only a pitch bend handler still counts as having handlers
+    UsbMidiHandlers bendOnly;
+    bendOnly.handlePitchBend = onPitchBend;
+    TEST_ASSERT_TRUE(bendOnly.hasHandlers());
+}
+
+void test_burst_latency(void) {
+    // Every packet in a burst is handled within the same rx callback. The queued path this replaced
+    // handled one message per MidiInterface::read(), so the last note of a burst waited BURST ticks.
+    uint8_t burst[BURST][4];
+    for (uint8_t i = 0; i < BURST; i++) {
+        burst[i][0] = 0x09;
+        burst[i][1] = 0x90;
+        burst[i][2] = 36 + i;
+        burst[i][3] = 100;
+    }
+    const int rounds = 10000;
+    uint64_t worst = 0;
+    uint64_t total = 0;
+    for (int round = 0; round < rounds; round++) {
+        noteOns = 0;
+        uint64_t start = nanos();
+        for (uint8_t i = 0; i < BURST; i++) {
+            handlers.dispatch(CABLE, burst[i]);
+        }
+        TEST_ASSERT_EQUAL_UINT8(BURST, noteOns);
+        uint64_t last = handledAt[BURST - 1] - start;
+        total += last;
+        if (last > worst) {
+            worst = last;
+        }
+    }
+    char message[96];
+    snprintf(message, sizeof(message), "last note of a %d packet burst handled after %llu ns on average, %llu ns worst", BURST, (unsigned long long)(total / rounds), (unsigned long long)worst);
+    TEST_MESSAGE(message);
+    // Well under the 1 ms between USB frames, even on a slow host
+    TEST_ASSERT_LESS_THAN(100000, total / rounds);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_note_on);
+    RUN_TEST(test_note_on_without_velocity_is_note_off);
+    RUN_TEST(test_control_change_and_pitch_bend);
+    RUN_TEST(test_other_cables_are_ignored);
+    RUN_TEST(test_missing_handlers_are_skipped);
+    RUN_TEST(test_burst_latency);
+    return UNITY_END();
+}
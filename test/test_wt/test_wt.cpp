@@ -0,0 +1,132 @@
+#include <string.h>
+#include <unity.h>
+
+#include "wt.h"
+
+#define SENSITIVITY 20
+#define REST 1000
+
+static Wt_Baseline_t wt;
+
+// Feeds a quiet pad at the given rate until it is ready, returning how long that took (ms)
+static uint32_t warm_up_at_rate(uint32_t samplesPerMs) {
+    uint32_t now = 0;
+    uint32_t samples = 0;
+    while (!wtReady(&wt)) {
+        // A little noise around the resting value
+        wtUpdate(&wt, REST + (samples % 5) - 2, SENSITIVITY, now);
+        samples++;
+        if (samples % samplesPerMs == 0) {
+            now++;
+        }
+    }
+    return now;
+}
+
+void setUp(void) {
+    memset(&wt, 0, sizeof(wt));
+}
+
+void tearDown(void) {}
+
+void test_first_sample_seeds_baseline(void) {
+    wtUpdate(&wt, REST, SENSITIVITY, 0);
+    TEST_ASSERT_EQUAL_UINT32(REST, wtBaseline(&wt));
+    TEST_ASSERT_EQUAL_UINT32(0, wtNoise(&wt));
+    TEST_ASSERT_FALSE(wtReady(&wt));
+}
+
+void test_warmup_is_timed_at_fast_rates(void) {
+    // At 20 samples per ms, WT_WARMUP samples take only a few ms, the warmup still lasts WT_WARMUP_MS
+    TEST_ASSERT_EQUAL_UINT32(WT_WARMUP_MS, warm_up_at_rate(20));
+    TEST_ASSERT_UINT_WITHIN(2, REST, wtBaseline(&wt));
+}
+
+void test_warmup_needs_enough_samples_at_slow_rates(void) {
+    // With one sample every 4ms, WT_WARMUP samples take longer than WT_WARMUP_MS
+    uint32_t now = 0;
+    uint16_t samples = 0;
+    while (!wtReady(&wt)) {
+        wtUpdate(&wt, REST, SENSITIVITY, now);
+        now += 4;
+        samples++;
+    }
+    TEST_ASSERT_EQUAL_UINT16(WT_WARMUP, samples);
+    TEST_ASSERT_EQUAL_UINT32(REST, wtBaseline(&wt));
+}
+
+void test_warmup_follows_settling_pad(void) {
+    // The pad settles from a high reading after power up, the baseline should end up at the settled value
+    uint32_t now = 0;
+    for (uint32_t i = 0; !wtReady(&wt); i++) {
+        uint32_t value = i < 2000 ? REST + 200 - i / 10 : REST;
+        wtUpdate(&wt, value, SENSITIVITY, now);
+        if (i % 20 == 19) {
+            now++;
+        }
+    }
+    TEST_ASSERT_UINT_WITHIN(2, REST, wtBaseline(&wt));
+}
+
+void test_tap_is_detected_and_not_absorbed(void) {
+    uint32_t now = warm_up_at_rate(20);
+    uint32_t baseline = wtBaseline(&wt);
+    TEST_ASSERT_FALSE(wtUpdate(&wt, REST + 2, SENSITIVITY, now));
+    // Hold a tap for a long time
+    for (int i = 0; i < 100000; i++) {
+        TEST_ASSERT_TRUE(wtUpdate(&wt, REST + 100, SENSITIVITY, now));
+    }
+    TEST_ASSERT_EQUAL_UINT32(baseline, wtBaseline(&wt));
+    TEST_ASSERT_FALSE(wtUpdate(&wt, REST, SENSITIVITY, now));
+}
+
+void test_small_changes_are_not_taps(void) {
+    uint32_t now = warm_up_at_rate(20);
+    TEST_ASSERT_FALSE(wtUpdate(&wt, REST + SENSITIVITY, SENSITIVITY, now));
+}
+
+void test_drift_is_followed(void) {
+    uint32_t now = warm_up_at_rate(20);
+    // Drift up slowly, well below the sensitivity per step
+    uint32_t value = REST;
+    for (int i = 0; i < 200000; i++) {
+        if (i % 5000 == 0) {
+            value++;
+        }
+        TEST_ASSERT_FALSE(wtUpdate(&wt, value, SENSITIVITY, now));
+    }
+    TEST_ASSERT_UINT_WITHIN(2, value, wtBaseline(&wt));
+    // And it falls back quickly
+    for (int i = 0; i < 200; i++) {
+        wtUpdate(&wt, REST, SENSITIVITY, now);
+    }
+    TEST_ASSERT_UINT_WITHIN(1, REST, wtBaseline(&wt));
+}
+
+void test_noise_raises_threshold(void) {
+    uint32_t now = 0;
+    // +-30 of noise
+    for (uint32_t i = 0; !wtReady(&wt); i++) {
+        wtUpdate(&wt, i & 1 ? REST + 30 : REST - 30, SENSITIVITY, now);
+        if (i % 20 == 19) {
+            now++;
+        }
+    }
+    TEST_ASSERT_UINT_WITHIN(3, 30, wtNoise(&wt));
+    // A jump that would count as a tap on a quiet pad isn't one on a noisy pad
+    TEST_ASSERT_FALSE(wtUpdate(&wt, REST + SENSITIVITY + 40, SENSITIVITY, now));
+    TEST_ASSERT_TRUE(wtUpdate(&wt, REST + SENSITIVITY + 100, SENSITIVITY, now));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_first_sample_seeds_baseline);
+    RUN_TEST(test_warmup_is_timed_at_fast_rates);
+    RUN_TEST(test_warmup_needs_enough_samples_at_slow_rates);
+    RUN_TEST(test_warmup_follows_settling_pad);
+    RUN_TEST(test_tap_is_detected_and_not_absorbed);
+    RUN_TEST(test_small_changes_are_not_taps);
+    RUN_TEST(test_drift_is_followed);
+    RUN_TEST(test_noise_raises_threshold);
+    return UNITY_END();
+}